@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "OdeExpression.h"
+#include "SolverStats.h"
+
+// PECE evaluates f again at the corrected value (two evaluations per step);
+// PEC keeps f at the predicted value as history (one evaluation per step).
+enum class AdamsMode
+{
+    Pece,
+    Pec,
+};
+
+// Fourth order Adams-Bashforth predictor with Adams-Moulton corrector on a
+// fixed step. The first three steps are taken with RK4 to fill the history,
+// after which each step costs one or two evaluations instead of RK4's four.
+template <typename T>
+class AdamsBashforthMoultonSolver
+{
+public:
+
+    AdamsBashforthMoultonSolver();
+
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    void SetMode(AdamsMode mode);
+
+    const SolverStats& GetStats() const;
+
+private:
+
+    static const int HistorySize = 4;
+    static const int TraceBatchSize = 256;
+
+    // f_(n - back) from the ring buffer of past derivatives
+    const T& Derivative(int back) const
+    {
+        return derivatives[(newest + HistorySize - back) % HistorySize];
+    }
+
+    void PushDerivative(const T& f)
+    {
+        newest = (newest + 1) % HistorySize;
+        derivatives[newest] = f;
+    }
+
+    T dydt(const T& t, const T& y)
+    {
+        stats.evaluations++;
+        return expression.Evaluate(t, y);
+    }
+
+    OdeExpression<T> expression;
+    AdamsMode mode = AdamsMode::Pece;
+    SolverStats stats;
+
+    T derivatives[HistorySize];
+    int newest = 0;
+};
@@ -0,0 +1,274 @@
+#include "AdjointSolver.h"
+#include "ButcherTableau.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+template <typename T>
+AdjointSolver<T>::AdjointSolver()
+{
+}
+
+template <typename T>
+void AdjointSolver<T>::CompileExpressions(const std::string& expression_string)
+{
+    if (!expression.Compile(expression_string, names))
+    {
+        throw std::runtime_error("Invalid expression: " + expression_string);
+    }
+    if (!running.empty() && !runningCost.Compile(running, names))
+    {
+        throw std::runtime_error("Invalid running cost: " + running);
+    }
+    if (!terminal.empty() && !terminalCost.Compile(terminal, names))
+    {
+        throw std::runtime_error("Invalid terminal cost: " + terminal);
+    }
+    for (size_t index = 0; index < names.size(); index++)
+    {
+        expression.SetParameterValue(int(index), parameterValues[index]);
+        if (!running.empty())
+        {
+            runningCost.SetParameterValue(int(index), parameterValues[index]);
+        }
+        if (!terminal.empty())
+        {
+            terminalCost.SetParameterValue(int(index), parameterValues[index]);
+        }
+    }
+}
+
+template <typename T>
+bool AdjointSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str, names);
+}
+
+template <typename T>
+bool AdjointSolver<T>::SetParameter(const std::string& name, const T& value)
+{
+    for (size_t index = 0; index < names.size(); index++)
+    {
+        if (names[index] == name)
+        {
+            parameterValues[index] = value;
+            return true;
+        }
+    }
+
+    if (!ExpressionTape<T>::IsParameterName(name))
+    {
+        return false;
+    }
+
+    names.push_back(name);
+    parameterValues.push_back(value);
+    return true;
+}
+
+template <typename T>
+const std::vector<std::string>& AdjointSolver<T>::GetParameterNames() const
+{
+    return names;
+}
+
+template <typename T>
+void AdjointSolver<T>::SetObjective(const std::string& running, const std::string& terminal)
+{
+    this->running = running;
+    this->terminal = terminal;
+}
+
+template <typename T>
+void AdjointSolver<T>::SetCheckpointBudget(long long states)
+{
+    budget = std::max(0LL, states);
+}
+
+template <typename T>
+const SolverStats& AdjointSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+const AdjointStats& AdjointSolver<T>::GetAdjointStats() const
+{
+    return adjointStats;
+}
+
+template <typename T>
+T AdjointSolver<T>::Step(const T& time, const T& y, const T& h, T* q)
+{
+    const T half = T(Rk4Tableau::C[1]);
+    const T b0 = T(Rk4Tableau::B[0]), b1 = T(Rk4Tableau::B[1]), b2 = T(Rk4Tableau::B[2]), b3 = T(Rk4Tableau::B[3]);
+
+    stats.evaluations += 4;
+    const T k1 = expression.Value(time, y);
+    const T y2 = y + h * (half * k1);
+    const T k2 = expression.Value(time + half * h, y2);
+    const T y3 = y + h * (half * k2);
+    const T k3 = expression.Value(time + half * h, y3);
+    const T y4 = y + h * k3;
+    const T k4 = expression.Value(time + h, y4);
+
+    if (q && !running.empty())
+    {
+        *q += h * (b0 * runningCost.Value(time, y) + b1 * runningCost.Value(time + half * h, y2)
+            + b2 * runningCost.Value(time + half * h, y3) + b3 * runningCost.Value(time + h, y4));
+    }
+    return y + h * (b0 * k1 + b1 * k2 + b2 * k3 + b3 * k4);
+}
+
+// The step y_n+1 = y + h sum b_i k_i, k_i = f(Y_i), Y_i = y + h a_i k_i-1
+// taken backwards: each stage's adjoint k_i bar = h b_i yBar plus what later
+// stages fed back, pulled through f at Y_i by one reverse sweep. The running
+// cost q_n+1 = q + h sum b_i g(Y_i) has adjoint 1, so g enters with weight h b_i.
+template <typename T>
+void AdjointSolver<T>::ReverseStep(const T& time, const T& y, const T& h, T& yBar, std::vector<T>& pBar)
+{
+    const T half = T(Rk4Tableau::C[1]);
+    const T b[4] = { T(Rk4Tableau::B[0]), T(Rk4Tableau::B[1]), T(Rk4Tableau::B[2]), T(Rk4Tableau::B[3]) };
+
+    // Stage states, recomputed from the start of the step
+    stats.evaluations += 3;
+    T stageState[4], stageTime[4];
+    stageState[0] = y;
+    stageTime[0] = time;
+    stageState[1] = y + h * (half * expression.Value(time, y));
+    stageTime[1] = time + half * h;
+    stageState[2] = y + h * (half * expression.Value(stageTime[1], stageState[1]));
+    stageTime[2] = time + half * h;
+    stageState[3] = y + h * expression.Value(stageTime[2], stageState[2]);
+    stageTime[3] = time + h;
+
+    // Y_i = y + h a_i k_i-1 with a = 1/2, 1/2, 1
+    const T a[4] = { T(0), half, half, T(1) };
+
+    T kBar[4];
+    for (int i = 0; i < 4; i++)
+    {
+        kBar[i] = h * b[i] * yBar;
+    }
+
+    T result = yBar;
+    stats.evaluations += 4;
+    for (int i = 3; i >= 0; i--)
+    {
+        T stateBar = T(0);
+        expression.AccumulateAdjoint(stageTime[i], stageState[i], kBar[i], stateBar, pBar.data());
+        if (!running.empty())
+        {
+            runningCost.AccumulateAdjoint(stageTime[i], stageState[i], h * b[i], stateBar, pBar.data());
+        }
+        result += stateBar;
+        if (i > 0)
+        {
+            kBar[i - 1] += h * a[i] * stateBar;
+        }
+    }
+    yBar = result;
+}
+
+template <typename T>
+T AdjointSolver<T>::Solve(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr, std::vector<T>& gradient)
+{
+    CompileExpressions(expr);
+    stats = SolverStats();
+    adjointStats = AdjointStats();
+
+    const int parameters = int(names.size());
+    gradient.assign(parameters + 1, T(0));
+    if (t0 >= t)
+    {
+        // No steps, so J = G(t0, y0) and only the terminal cost has a gradient
+        if (terminal.empty())
+        {
+            return T(0);
+        }
+        return terminalCost.AccumulateAdjoint(t0, y0, T(1), gradient[parameters], gradient.data());
+    }
+
+    const long long steps = (long long)std::ceil((t - t0) / h);
+
+    // Segment length C: ceil(N / C) checkpoints and C - 1 recomputed states
+    // are held at once, so take the shortest segments the budget allows
+    long long length = 1;
+    if (budget > 0 && budget < steps)
+    {
+        long long best = steps;
+        for (long long candidate = 1; candidate <= steps; candidate++)
+        {
+            const long long held = (steps + candidate - 1) / candidate + candidate - 1;
+            if (held <= budget)
+            {
+                length = candidate;
+                break;
+            }
+            if (held < best)
+            {
+                best = held;
+                length = candidate;
+            }
+        }
+    }
+    const long long segments = (steps + length - 1) / length;
+
+    auto timeAt = [&](long long index) { return t0 + T(index) * h; };
+
+    // Forward pass, keeping the state at the start of every segment
+    T y = y0, q = T(0);
+    {
+        TraceSpan forwardSpan("forward");
+        checkpoints.resize(segments);
+        for (long long index = 0; index < steps; index++)
+        {
+            if (index % length == 0)
+            {
+                checkpoints[index / length] = y;
+            }
+            y = Step(timeAt(index), y, h, &q);
+        }
+    }
+    stats.steps = steps;
+
+    T objective = q;
+    T yBar = T(0);
+    if (!terminal.empty())
+    {
+        objective += terminalCost.Value(timeAt(steps), y);
+        terminalCost.AccumulateAdjoint(timeAt(steps), y, T(1), yBar, gradient.data());
+    }
+
+    // Backward pass, one segment at a time from the last
+    TraceSpan backwardSpan("adjoint");
+    segment.resize(length);
+    for (long long s = segments - 1; s >= 0; s--)
+    {
+        const long long first = s * length;
+        const long long last = std::min(steps, first + length);
+
+        segment[0] = checkpoints[s];
+        for (long long index = first; index + 1 < last; index++)
+        {
+            segment[index + 1 - first] = Step(timeAt(index), segment[index - first], h, nullptr);
+            adjointStats.recomputedSteps++;
+        }
+
+        for (long long index = last - 1; index >= first; index--)
+        {
+            ReverseStep(timeAt(index), segment[index - first], h, yBar, gradient);
+        }
+    }
+    gradient[parameters] = yBar;
+
+    adjointStats.checkpoints = segments;
+    adjointStats.segmentLength = length;
+    adjointStats.peakStates = segments + length - 1;
+    return objective;
+}
+
+template class AdjointSolver<float>;
+template class AdjointSolver<double>;
+template class AdjointSolver<long double>;
@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SensitivityExpression.h"
+#include "SolverStats.h"
+
+// Checkpointing counts from the last AdjointSolver::Solve
+struct AdjointStats
+{
+    long long checkpoints = 0;
+    long long segmentLength = 0;
+    long long recomputedSteps = 0;
+    long long peakStates = 0;
+};
+
+// Gradient of J = G(y(t_f)) + integral over [t0, t_f] of g(t, y) with
+// respect to every named parameter and y0, by the discrete adjoint of
+// fixed-step RK4. The running cost is integrated as an extra RK4 component,
+// so J and its gradient belong to the same discrete solution. The forward
+// pass keeps the state only at checkpoints. The backward pass then goes
+// through the steps in reverse, recomputing each segment's states from its
+// checkpoint. Each stage costs one reverse sweep over the expression tapes,
+// so the gradient costs a fixed multiple of a Solve however many parameters
+// there are, unlike SensitivitySolver whose cost grows with their number.
+template <typename T>
+class AdjointSolver
+{
+public:
+
+    AdjointSolver();
+
+    // Returns J and fills gradient with dJ/dp_j in the order the parameters
+    // were first set, then dJ/dy0
+    T Solve(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr, std::vector<T>& gradient);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    // Sets a parameter's value, adding it to the gradient if it is new.
+    // Returns false if the name is not an identifier or is t, y, pi or epsilon.
+    bool SetParameter(const std::string& name, const T& value);
+
+    const std::vector<std::string>& GetParameterNames() const;
+
+    // running is g(t, y) and terminal G(y), both in terms of t, y and the
+    // parameters; an empty string leaves that part out of J
+    void SetObjective(const std::string& running, const std::string& terminal);
+
+    // Most states held at once by checkpoints and the recomputed segment;
+    // 0 keeps every step and recomputes nothing. A budget below about
+    // 2 sqrt(steps) cannot be met by two-level checkpointing and is exceeded
+    // by as little as possible.
+    void SetCheckpointBudget(long long states);
+
+    const SolverStats& GetStats() const;
+
+    const AdjointStats& GetAdjointStats() const;
+
+private:
+
+    void CompileExpressions(const std::string& expression_string);
+
+    // One RK4 step of y from (time, y), also advancing the running cost q
+    // unless it is null
+    T Step(const T& time, const T& y, const T& h, T* q);
+
+    // Given yBar = dJ/dy_n+1 on entry, leaves dJ/dy_n and adds this step's
+    // contributions to pBar
+    void ReverseStep(const T& time, const T& y, const T& h, T& yBar, std::vector<T>& pBar);
+
+    SensitivityExpression<T> expression;
+    SensitivityExpression<T> runningCost;
+    SensitivityExpression<T> terminalCost;
+    std::string running;
+    std::string terminal;
+    std::vector<std::string> names;
+    std::vector<T> parameterValues;
+    long long budget = 0;
+
+    std::vector<T> checkpoints;
+    std::vector<T> segment;
+    SolverStats stats;
+    AdjointStats adjointStats;
+};
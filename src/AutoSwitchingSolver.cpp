@@ -0,0 +1,204 @@
+#include "AutoSwitchingSolver.h"
+#include "ButcherTableau.h"
+#include "ExplicitRungeKutta.h"
+#include "RosenbrockSolver.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    // Dormand-Prince is stable for h lambda down to about -3.3 on the real axis.
+    // A step size held above StiffRatio of that boundary is limited by stability
+    // rather than accuracy; below NonStiffRatio the explicit method is safe.
+    const double StabilityBoundary = 3.3;
+    const double StiffRatio = 0.8;
+    const double NonStiffRatio = 0.5;
+}
+
+template <typename T>
+AutoSwitchingSolver<T>::AutoSwitchingSolver()
+{
+}
+
+template <typename T>
+bool AutoSwitchingSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str);
+}
+
+template <typename T>
+void AutoSwitchingSolver<T>::SetTolerances(const T& relative, const T& absolute)
+{
+    relativeTolerance = relative;
+    absoluteTolerance = absolute;
+}
+
+template <typename T>
+const SolverStats& AutoSwitchingSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+const RegimeStats<T>& AutoSwitchingSolver<T>::GetRegimeStats() const
+{
+    return regimeStats;
+}
+
+template <typename T>
+void AutoSwitchingSolver<T>::Solve(const T& y0, const T& h0, const T& t, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    if (!expression.Compile(expr))
+    {
+        throw std::runtime_error("Invalid expression: " + expr);
+    }
+    stats = SolverStats();
+    regimeStats = RegimeStats<T>();
+
+    TraceSpan solveSpan("solve");
+
+    typedef ExplicitRungeKutta<DormandPrinceTableau, T> Explicit;
+    const T explicitExponent = T(1) / 5;
+    const T implicitExponent = T(1) / 3;
+    const T d = RosenbrockW<T>::Gamma();
+    const T minStep = 16 * std::numeric_limits<T>::epsilon();
+
+    auto f = [this](const T& time, const T& y) { return dydt(time, y); };
+    T w = y0;
+    T i = t0;
+    T h = std::min(h0, t - t0);
+    T f0 = dydt(i, w);
+
+    bool stiff = false;
+    bool rejected = false;
+    int sinceCheck = 0;
+    int switchVotes = 0;
+
+    T jacobian = T(0), inverse = T(0), factoredStep = T(0);
+    bool jacobianCurrent = false;
+    int jacobianAge = 0;
+
+    out.clear();
+    out.push_back({ i, w });
+
+    while (i < t)
+    {
+        if (h <= minStep * std::max(T(1), std::fabs(i)))
+        {
+            throw std::runtime_error("Step size underflow in auto-switching integration");
+        }
+
+        const T last = i + h >= t ? t : i + h;
+        const T step = last - i;
+        bool sampledJacobian = false;
+
+        if (stiff && jacobianAge >= MaxJacobianAge)
+        {
+            jacobian = expression.PartialY(i, w);
+            stats.jacobianEvaluations++;
+            jacobianCurrent = true;
+            sampledJacobian = true;
+            jacobianAge = 0;
+            factoredStep = T(0);
+        }
+
+        T next, error, f2;
+        if (stiff)
+        {
+            const T timeDerivative = RosenbrockW<T>::TimeDerivative(f, i, w, step, f0);
+            if (step != factoredStep)
+            {
+                inverse = T(1) / (T(1) - step * d * jacobian);
+                factoredStep = step;
+                stats.factorizations++;
+            }
+            next = RosenbrockW<T>::Step(f, i, w, step, f0, timeDerivative, inverse, f2, error);
+        }
+        else
+        {
+            next = Explicit::Step(f, i, w, step, f0, f2, error);
+        }
+
+        const T scale = absoluteTolerance + relativeTolerance * std::max(std::fabs(w), std::fabs(next));
+        const T ratio = std::fabs(error) / scale;
+        const T exponent = stiff ? implicitExponent : explicitExponent;
+        const T factor = ratio == 0 ? T(5) : std::min(T(5), std::max(T(0.2), T(0.9) * std::pow(ratio, -exponent)));
+
+        if (ratio > 1)
+        {
+            stats.rejectedSteps++;
+            rejected = true;
+            if (stiff && !jacobianCurrent)
+            {
+                // Retry with a fresh Jacobian before giving up step size
+                jacobianAge = MaxJacobianAge;
+            }
+            else
+            {
+                h = step * std::min(T(1), factor);
+            }
+            continue;
+        }
+
+        // Both methods leave f(t + h, y_n+1) in f2, ready for the next step
+        i = last;
+        w = next;
+        f0 = f2;
+        out.push_back({ i, w });
+        stats.steps++;
+        h = step * (rejected ? std::min(T(1), factor) : factor);
+        rejected = false;
+
+        if (stiff)
+        {
+            regimeStats.implicitSteps++;
+            jacobianAge++;
+            jacobianCurrent = false;
+        }
+        else
+        {
+            regimeStats.explicitSteps++;
+            if (++sinceCheck >= StiffnessCheckInterval)
+            {
+                sinceCheck = 0;
+                jacobian = expression.PartialY(i, w);
+                stats.jacobianEvaluations++;
+                sampledJacobian = true;
+            }
+        }
+
+        if (!sampledJacobian)
+        {
+            continue;
+        }
+
+        // Compare the accepted step with the explicit stability limit
+        const T stiffness = step * std::fabs(jacobian);
+        const bool favoursSwitch = stiff ? stiffness < T(NonStiffRatio * StabilityBoundary) : stiffness > T(StiffRatio * StabilityBoundary);
+        switchVotes = favoursSwitch ? switchVotes + 1 : 0;
+        if (switchVotes >= SwitchPatience)
+        {
+            stiff = !stiff;
+            switchVotes = 0;
+            sinceCheck = 0;
+            regimeStats.switchTimes.push_back(i);
+
+            // The last sample is recent enough to start the implicit phase with
+            jacobianAge = 0;
+            jacobianCurrent = false;
+            factoredStep = T(0);
+        }
+    }
+}
+
+template class AutoSwitchingSolver<float>;
+template class AutoSwitchingSolver<double>;
+template class AutoSwitchingSolver<long double>;
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "OdeExpression.h"
+#include "SolverStats.h"
+
+// Steps taken in each regime by AutoSwitchingSolver and the times it switched
+template <typename T>
+struct RegimeStats
+{
+    long long explicitSteps = 0;
+    long long implicitSteps = 0;
+    std::vector<T> switchTimes;
+};
+
+// LSODA-style driver that follows the problem between non-stiff and stiff
+// phases. It integrates with adaptive Dormand-Prince 5(4) while that is cheap
+// and switches to the Rosenbrock-W pair once the step size is held at the
+// explicit stability boundary, i.e. h |df/dy| stays near 3.3. It switches back
+// when the implicit steps become small enough for the explicit method to take
+// them stably. df/dy, the dominant (and for a scalar problem only) eigenvalue,
+// is sampled every few explicit steps and on every Jacobian refresh.
+template <typename T>
+class AutoSwitchingSolver
+{
+public:
+
+    AutoSwitchingSolver();
+
+    // h is the initial step; the output holds every accepted step
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    void SetTolerances(const T& relative, const T& absolute);
+
+    const SolverStats& GetStats() const;
+
+    const RegimeStats<T>& GetRegimeStats() const;
+
+private:
+
+    static const int StiffnessCheckInterval = 5;
+    static const int SwitchPatience = 2;
+    static const int MaxJacobianAge = 10;
+
+    T dydt(const T& t, const T& y)
+    {
+        stats.evaluations++;
+        return expression.Evaluate(t, y);
+    }
+
+    OdeExpression<T> expression;
+    T relativeTolerance = T(1e-6);
+    T absoluteTolerance = T(1e-6);
+    SolverStats stats;
+    RegimeStats<T> regimeStats;
+};
@@ -0,0 +1,133 @@
+#include "BatchedEnsembleSolver.h"
+#include "LaneKernel.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+template <typename T>
+BatchedEnsembleSolver<T>::BatchedEnsembleSolver(int threads) : scheduler(threads), simdLevel(DetectSimdLevel())
+{
+    for (int worker = 0; worker < scheduler.GetThreadCount(); worker++)
+    {
+        expressions.push_back(std::make_unique<BatchExpression<T>>());
+    }
+}
+
+template <typename T>
+bool BatchedEnsembleSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expressions[0]->Compile(expression_str);
+}
+
+template <typename T>
+void BatchedEnsembleSolver<T>::SetSimdLevel(SimdLevel level)
+{
+    simdLevel = std::min(level, DetectSimdLevel());
+}
+
+template <typename T>
+SimdLevel BatchedEnsembleSolver<T>::GetSimdLevel() const
+{
+    return simdLevel;
+}
+
+template <typename T>
+const SolverStats& BatchedEnsembleSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+double BatchedEnsembleSolver<T>::GetLaneUtilisation() const
+{
+    return laneSteps > 0 ? double(stats.steps) / laneSteps : 1.0;
+}
+
+template <typename T>
+void BatchedEnsembleSolver<T>::Solve(const std::vector<EnsembleMember<T>>& members, const std::string& expr,
+    std::vector<std::vector<T>>& out)
+{
+    for (std::unique_ptr<BatchExpression<T>>& expression : expressions)
+    {
+        if (!expression->Compile(expr))
+        {
+            throw std::runtime_error("Invalid expression: " + expr);
+        }
+    }
+
+    TraceSpan solveSpan("batched ensemble");
+
+    const int count = int(members.size());
+    const int blocks = (count + Lanes - 1) / Lanes;
+    out.assign(members.size(), std::vector<T>(2));
+    workerLaneSteps.assign(scheduler.GetThreadCount(), 0);
+
+    scheduler.Run(blocks, 1, [&](int worker, int block)
+        {
+            SolveBlock(worker, members, block * Lanes, out);
+        });
+
+    stats = SolverStats();
+    for (const EnsembleMember<T>& member : members)
+    {
+        if (member.t0 < member.t)
+        {
+            stats.steps += (long long)std::ceil((member.t - member.t0) / member.h);
+        }
+    }
+    stats.evaluations = 4 * stats.steps;
+    laneSteps = 0;
+    for (long long workerSteps : workerLaneSteps)
+    {
+        laneSteps += workerSteps;
+    }
+}
+
+template <typename T>
+void BatchedEnsembleSolver<T>::SolveBlock(int worker, const std::vector<EnsembleMember<T>>& members, int first,
+    std::vector<std::vector<T>>& out)
+{
+    const int used = std::min(Lanes, int(members.size()) - first);
+
+    // Spare lanes of the last block repeat its first member with no steps
+    LaneBlock<T> block;
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        const EnsembleMember<T>& member = members[first + (lane < used ? lane : 0)];
+        const long long steps = lane < used && member.t0 < member.t
+            ? (long long)std::ceil((member.t - member.t0) / member.h) : 0;
+        block.t0[lane] = member.t0;
+        block.h[lane] = member.h;
+        block.steps[lane] = T(steps);
+        block.y[lane] = member.y0;
+        block.maxSteps = std::max(block.maxSteps, steps);
+    }
+
+    BatchExpression<T>& f = *expressions[worker];
+    switch (simdLevel)
+    {
+#if SIMD_DISPATCH
+    case SimdLevel::Avx512:
+        IntegrateLanesAvx512(f, block);
+        break;
+    case SimdLevel::Avx2:
+        IntegrateLanesAvx2(f, block);
+        break;
+#endif
+    default:
+        IntegrateLanesScalar(f, block);
+        break;
+    }
+
+    for (int lane = 0; lane < used; lane++)
+    {
+        const T steps = block.steps[lane];
+        out[first + lane] = { block.t0[lane] + steps * block.h[lane], block.y[lane] };
+    }
+    workerLaneSteps[worker] += block.maxSteps * Lanes;
+}
+
+template class BatchedEnsembleSolver<float>;
+template class BatchedEnsembleSolver<double>;
+template class BatchedEnsembleSolver<long double>;
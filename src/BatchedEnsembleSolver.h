@@ -0,0 +1,61 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "BatchExpression.h"
+#include "EnsembleSolver.h"
+#include "SimdDispatch.h"
+#include "SolverStats.h"
+#include "WorkStealingScheduler.h"
+
+// Fixed-step RK4 over an ensemble with the members packed into blocks of
+// BatchExpression::Lanes, one member per lane. Each RK4 stage evaluates the
+// right-hand side for the whole block and does the stage arithmetic as lane
+// loops, so a block costs about as much as one member does in
+// RungeKuttaSolver when the expression is mostly arithmetic. Members may have
+// their own h, t0 and t; a lane that has taken all its steps keeps running
+// with a zero step until the longest member of its block is done, so blocks of
+// similar members waste least. Blocks are shared out on a
+// WorkStealingScheduler, with a BatchExpression per worker.
+template <typename T>
+class BatchedEnsembleSolver
+{
+public:
+
+    static constexpr int Lanes = BatchExpression<T>::Lanes;
+
+    // 0 threads uses one per hardware thread
+    explicit BatchedEnsembleSolver(int threads = 0);
+
+    // out[m] receives { t, y } at the end of member m, the last row
+    // RungeKuttaSolver::Solve writes for a fixed-step RK4 run with the same
+    // arguments; h is the fixed step of each member
+    void Solve(const std::vector<EnsembleMember<T>>& members, const std::string& expr,
+        std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    // Defaults to DetectSimdLevel(); a level the CPU lacks falls back to that
+    void SetSimdLevel(SimdLevel level);
+
+    SimdLevel GetSimdLevel() const;
+
+    // Totals over all members, counted as RungeKuttaSolver would count them
+    const SolverStats& GetStats() const;
+
+    // Member steps over lane steps run, 1 when every lane of every block is
+    // busy to the end
+    double GetLaneUtilisation() const;
+
+private:
+
+    void SolveBlock(int worker, const std::vector<EnsembleMember<T>>& members, int first,
+        std::vector<std::vector<T>>& out);
+
+    WorkStealingScheduler scheduler;
+    std::vector<std::unique_ptr<BatchExpression<T>>> expressions;
+    std::vector<long long> workerLaneSteps;
+    SimdLevel simdLevel;
+    SolverStats stats;
+    long long laneSteps = 0;
+};
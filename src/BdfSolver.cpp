@@ -0,0 +1,298 @@
+#include "BdfSolver.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+template <typename T>
+BdfSolver<T>::BdfSolver()
+{
+}
+
+template <typename T>
+bool BdfSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str);
+}
+
+template <typename T>
+void BdfSolver<T>::SetTolerances(const T& relative, const T& absolute)
+{
+    relativeTolerance = relative;
+    absoluteTolerance = absolute;
+}
+
+template <typename T>
+const SolverStats& BdfSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+// Rewrites the backward differences of the current interpolating polynomial
+// for a step size multiplied by factor
+template <typename T>
+void BdfSolver<T>::RescaleDifferences(int order, const T& factor)
+{
+    T r[MaxOrder + 1][MaxOrder + 1];
+    T u[MaxOrder + 1][MaxOrder + 1];
+    for (int j = 0; j <= order; j++)
+    {
+        r[0][j] = T(1);
+        u[0][j] = T(1);
+    }
+    for (int i = 1; i <= order; i++)
+    {
+        r[i][0] = T(0);
+        u[i][0] = T(0);
+        for (int j = 1; j <= order; j++)
+        {
+            r[i][j] = r[i - 1][j] * (i - 1 - factor * j) / i;
+            u[i][j] = u[i - 1][j] * (i - 1 - j) / T(i);
+        }
+    }
+
+    T rescaled[MaxOrder + 1];
+    for (int k = 0; k <= order; k++)
+    {
+        rescaled[k] = T(0);
+        for (int i = 0; i <= order; i++)
+        {
+            T ru = T(0);
+            for (int j = 0; j <= order; j++)
+            {
+                ru += r[i][j] * u[j][k];
+            }
+            rescaled[k] += ru * differences[i];
+        }
+    }
+    std::copy(rescaled, rescaled + order + 1, differences);
+}
+
+// Simplified Newton iteration for the BDF corrector. Returns false if the
+// iteration diverges or converges too slowly to meet the tolerance.
+template <typename T>
+bool BdfSolver<T>::SolveCorrector(const T& time, const T& predicted, const T& c, const T& psi, const T& scale,
+    const T& tolerance, int& iterations, T& y, T& correction)
+{
+    y = predicted;
+    correction = T(0);
+    T previousNorm = T(-1);
+
+    for (iterations = 1; iterations <= NewtonMaxIterations; iterations++)
+    {
+        const T f = dydt(time, y);
+        if (!std::isfinite(f))
+        {
+            return false;
+        }
+
+        const T delta = inverse * (c * f - psi - correction);
+        const T norm = std::fabs(delta) / scale;
+        const T rate = previousNorm > 0 ? norm / previousNorm : T(-1);
+        if (rate >= 0 && (rate >= 1 || std::pow(rate, T(NewtonMaxIterations - iterations + 1)) / (1 - rate) * norm > tolerance))
+        {
+            return false;
+        }
+
+        y += delta;
+        correction += delta;
+        if (norm == 0 || (rate >= 0 && rate / (1 - rate) * norm < tolerance))
+        {
+            return true;
+        }
+        previousNorm = norm;
+    }
+    return false;
+}
+
+template <typename T>
+void BdfSolver<T>::Solve(const T& y0, const T& h0, const T& t, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    if (!expression.Compile(expr))
+    {
+        throw std::runtime_error("Invalid expression: " + expr);
+    }
+    stats = SolverStats();
+
+    TraceSpan solveSpan("solve");
+
+    // gamma_k = sum_{j <= k} 1/j; the BDF error constant of order k is 1 / (k + 1)
+    T gamma[MaxOrder + 2];
+    T errorConstant[MaxOrder + 2];
+    gamma[0] = T(0);
+    for (int k = 1; k <= MaxOrder + 1; k++)
+    {
+        gamma[k] = gamma[k - 1] + T(1) / k;
+    }
+    for (int k = 0; k <= MaxOrder + 1; k++)
+    {
+        errorConstant[k] = T(1) / (k + 1);
+    }
+
+    const T newtonTolerance = std::max(10 * std::numeric_limits<T>::epsilon() / relativeTolerance,
+        std::min(T(0.03), std::sqrt(relativeTolerance)));
+    const T minStep = 16 * std::numeric_limits<T>::epsilon();
+
+    T i = t0;
+    T h = std::min(h0, t - t0);
+    int order = 1;
+    int equalSteps = 0;
+
+    std::fill(differences, differences + MaxOrder + 3, T(0));
+    differences[0] = y0;
+    differences[1] = h * dydt(t0, y0);
+
+    T jacobian = expression.PartialY(t0, y0);
+    stats.jacobianEvaluations++;
+    bool factored = false;
+
+    out.clear();
+    out.push_back({ i, y0 });
+
+    while (i < t)
+    {
+        T next = T(0), correction = T(0), errorNorm = T(0), safety = T(0);
+        bool accepted = false;
+        bool jacobianCurrent = false;
+
+        while (!accepted)
+        {
+            if (h <= minStep * std::max(T(1), std::fabs(i)))
+            {
+                throw std::runtime_error("Step size underflow in BDF integration");
+            }
+
+            if (i + h > t)
+            {
+                RescaleDifferences(order, (t - i) / h);
+                h = t - i;
+                equalSteps = 0;
+                factored = false;
+            }
+
+            const T time = i + h;
+            T predicted = T(0);
+            for (int k = 0; k <= order; k++)
+            {
+                predicted += differences[k];
+            }
+            T psi = T(0);
+            for (int k = 1; k <= order; k++)
+            {
+                psi += differences[k] * gamma[k];
+            }
+            psi /= gamma[order];
+            const T c = h / gamma[order];
+            T scale = absoluteTolerance + relativeTolerance * std::fabs(predicted);
+
+            bool converged = false;
+            int iterations = 0;
+            while (!converged)
+            {
+                if (!factored)
+                {
+                    inverse = T(1) / (T(1) - c * jacobian);
+                    factored = true;
+                    stats.factorizations++;
+                }
+
+                converged = SolveCorrector(time, predicted, c, psi, scale, newtonTolerance, iterations, next, correction);
+                if (!converged)
+                {
+                    if (jacobianCurrent)
+                    {
+                        break;
+                    }
+                    jacobian = expression.PartialY(time, predicted);
+                    stats.jacobianEvaluations++;
+                    jacobianCurrent = true;
+                    factored = false;
+                }
+            }
+
+            if (!converged)
+            {
+                stats.rejectedSteps++;
+                h *= T(0.5);
+                RescaleDifferences(order, T(0.5));
+                equalSteps = 0;
+                factored = false;
+                continue;
+            }
+
+            safety = T(0.9) * (2 * NewtonMaxIterations + 1) / (2 * NewtonMaxIterations + iterations);
+            scale = absoluteTolerance + relativeTolerance * std::fabs(next);
+            errorNorm = std::fabs(errorConstant[order] * correction) / scale;
+            if (errorNorm > 1)
+            {
+                stats.rejectedSteps++;
+                const T factor = std::max(T(0.2), safety * std::pow(errorNorm, -T(1) / (order + 1)));
+                h *= factor;
+                RescaleDifferences(order, factor);
+                equalSteps = 0;
+                factored = false;
+            }
+            else
+            {
+                accepted = true;
+            }
+        }
+
+        i += h;
+        if (t - i <= minStep * std::max(T(1), std::fabs(t)))
+        {
+            i = t;
+        }
+        out.push_back({ i, next });
+        stats.steps++;
+        equalSteps++;
+
+        // correction is the (order + 1)-th backward difference of the new polynomial
+        differences[order + 2] = correction - differences[order + 1];
+        differences[order + 1] = correction;
+        for (int k = order; k >= 0; k--)
+        {
+            differences[k] += differences[k + 1];
+        }
+
+        if (equalSteps < order + 1)
+        {
+            continue;
+        }
+
+        // Pick the order whose error estimate allows the largest next step
+        const T scale = absoluteTolerance + relativeTolerance * std::fabs(next);
+        const T lowerNorm = order > 1 ? std::fabs(errorConstant[order - 1] * differences[order]) / scale : std::numeric_limits<T>::infinity();
+        const T higherNorm = order < MaxOrder ? std::fabs(errorConstant[order + 1] * differences[order + 2]) / scale : std::numeric_limits<T>::infinity();
+        const T norms[3] = { lowerNorm, errorNorm, higherNorm };
+
+        int best = 0;
+        T bestFactor = T(-1);
+        for (int candidate = 0; candidate < 3; candidate++)
+        {
+            const T factor = norms[candidate] == 0 ? std::numeric_limits<T>::infinity() : std::pow(norms[candidate], -T(1) / (order + candidate));
+            if (factor > bestFactor)
+            {
+                bestFactor = factor;
+                best = candidate;
+            }
+        }
+
+        order += best - 1;
+        const T factor = std::min(T(10), safety * bestFactor);
+        h *= factor;
+        RescaleDifferences(order, factor);
+        equalSteps = 0;
+        factored = false;
+    }
+}
+
+template class BdfSolver<float>;
+template class BdfSolver<double>;
+template class BdfSolver<long double>;
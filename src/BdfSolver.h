@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "OdeExpression.h"
+#include "SolverStats.h"
+
+// Variable order (1 to 5), variable step BDF for stiff problems, in the
+// quasi-constant step size form of Shampine's ode15s: the history is kept as
+// backward differences which are rescaled whenever the step size changes.
+// Each step solves the implicit formula by simplified Newton iteration; df/dy
+// is only re-evaluated when the iteration fails to converge and the scalar
+// iteration matrix is only refactored when the step size or order changes.
+template <typename T>
+class BdfSolver
+{
+public:
+
+    BdfSolver();
+
+    // h is the initial step; the output holds every accepted step
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    void SetTolerances(const T& relative, const T& absolute);
+
+    const SolverStats& GetStats() const;
+
+private:
+
+    static const int MaxOrder = 5;
+    static const int NewtonMaxIterations = 4;
+
+    void RescaleDifferences(int order, const T& factor);
+
+    bool SolveCorrector(const T& time, const T& predicted, const T& c, const T& psi, const T& scale,
+        const T& tolerance, int& iterations, T& y, T& correction);
+
+    T dydt(const T& t, const T& y)
+    {
+        stats.evaluations++;
+        return expression.Evaluate(t, y);
+    }
+
+    OdeExpression<T> expression;
+    T relativeTolerance = T(1e-6);
+    T absoluteTolerance = T(1e-6);
+    SolverStats stats;
+
+    T differences[MaxOrder + 3];
+    T inverse = T(0);
+};
@@ -0,0 +1,1604 @@
+#include "Benchmarks.h"
+#include "AdamsBashforthMoultonSolver.h"
+#include "AdjointSolver.h"
+#include "AutoSwitchingSolver.h"
+#include "BatchedEnsembleSolver.h"
+#include "BdfSolver.h"
+#include "BulirschStoerSolver.h"
+#include "ColumnarFile.h"
+#include "DenseOutput.h"
+#include "EnsembleSolver.h"
+#include "MixedPrecisionSolver.h"
+#include "OdeSolution.h"
+#include "ParameterFitter.h"
+#include "PararealSolver.h"
+#include "RosenbrockSolver.h"
+#include "RungeKuttaSolver.h"
+#include "SensitivitySolver.h"
+#include "SlidingWindow.h"
+#include "ShootingSolver.h"
+#include "SweepEngine.h"
+#include "TaylorSolver.h"
+#include "TrajectorySummary.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef int (*BenchmarkFunction)();
+
+    struct Benchmark
+    {
+        const char* name;
+        const char* description;
+        BenchmarkFunction run;
+    };
+
+    // y' = -2ty, y(0) = 1 has the exact solution y = exp(-t^2)
+    const char* GaussianExpression = "-2*t*y";
+
+    long double GaussianExact(long double t)
+    {
+        return std::exp(-t * t);
+    }
+
+    double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Final-time error of RK4 on y' = -2ty over [0, 2] for 2^0 .. 2^(count-1) steps
+    template <typename T>
+    std::vector<long double> GaussianErrors(int count, double& seconds)
+    {
+        RungeKuttaSolver<T> rk;
+        std::vector<std::vector<T>> out;
+        std::vector<long double> errors;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int power = 0; power < count; power++)
+        {
+            const long steps = 1L << power;
+            const T h = T(2) / T(steps);
+            rk.Solve(T(1), h, T(2), T(0), GaussianExpression, out);
+            errors.push_back(std::fabs((long double)out.back()[1] - GaussianExact(2)));
+        }
+        seconds = SecondsSince(start);
+        return errors;
+    }
+
+    template <typename T>
+    void PrintStepsForTargets(const char* label, const std::vector<long double>& targets, int count)
+    {
+        double seconds = 0;
+        const std::vector<long double> errors = GaussianErrors<T>(count, seconds);
+
+        long double best = errors[0];
+        for (long double error : errors)
+        {
+            best = std::min(best, error);
+        }
+
+        std::cout << std::left << std::setw(13) << label;
+        for (long double target : targets)
+        {
+            int power = 0;
+            while (power < count && errors[power] > target)
+            {
+                power++;
+            }
+
+            std::cout << std::right << std::setw(10);
+            if (power < count)
+            {
+                std::cout << (1L << power);
+            }
+            else
+            {
+                std::cout << "-";
+            }
+        }
+        std::cout << std::right << std::setw(14) << std::scientific << std::setprecision(2) << (double)best
+            << std::setw(10) << std::fixed << std::setprecision(2) << seconds << "\n";
+    }
+
+    // Steps RK4 needs to reach a target final error in each precision
+    int PrecisionBenchmark()
+    {
+        const int count = 18;
+        const std::vector<long double> targets = { 1e-4L, 1e-6L, 1e-8L, 1e-10L, 1e-12L, 1e-14L };
+
+        std::cout << "RK4 steps needed for |y(2) - exp(-4)| <= target, y' = " << GaussianExpression << ", y(0) = 1\n";
+        std::cout << "(- means the target was not reached with up to " << (1L << (count - 1)) << " steps)\n\n";
+        std::cout << std::left << std::setw(13) << "precision";
+        for (long double target : targets)
+        {
+            std::cout << std::right << std::setw(10) << std::scientific << std::setprecision(0) << (double)target;
+        }
+        std::cout << std::setw(14) << "best error" << std::setw(10) << "seconds" << "\n";
+
+        PrintStepsForTargets<float>("float", targets, count);
+        PrintStepsForTargets<double>("double", targets, count);
+        PrintStepsForTargets<long double>("long double", targets, count);
+        return 0;
+    }
+
+    template <typename Solver, typename T>
+    void PrintMixedRow(const char* label, const char* expr, T h, T tf, long double exact)
+    {
+        Solver solver;
+        std::vector<std::vector<T>> out;
+
+        const auto start = std::chrono::steady_clock::now();
+        solver.Solve(T(0), h, tf, T(0), expr, out);
+        const double seconds = SecondsSince(start);
+
+        const long double error = std::fabs((long double)out.back()[1] - exact);
+        std::cout << std::left << std::setw(28) << label << std::right << std::setw(12) << std::scientific << std::setprecision(2)
+            << (double)error << std::setw(10) << std::fixed << std::setprecision(3) << seconds << "\n";
+    }
+
+    // Accuracy and cost of float evaluation with wider or compensated state accumulation
+    int MixedPrecisionBenchmark()
+    {
+        const char* expr = "cos(t)";
+        const double tf = 100;
+        const double h = 1e-4;
+        const long double exact = std::sin(100.0L);
+
+        std::cout << "RK4 on y' = " << expr << ", y(0) = 0 over [0, " << tf << "] with h = " << h << " (" << long(tf / h) << " steps)\n\n";
+        std::cout << std::left << std::setw(28) << "mode" << std::right << std::setw(12) << "|error|" << std::setw(10) << "seconds" << "\n";
+
+        PrintMixedRow<RungeKuttaSolver<float>, float>("float", expr, float(h), float(tf), exact);
+        PrintMixedRow<MixedPrecisionSolver<CompensatedFloat>, double>("float eval, Kahan state", expr, h, tf, exact);
+        PrintMixedRow<MixedPrecisionSolver<double>, double>("float eval, double state", expr, h, tf, exact);
+        PrintMixedRow<RungeKuttaSolver<double>, double>("double", expr, h, tf, exact);
+        return 0;
+    }
+
+    // Fewest fixed-step evaluations of a method reaching each target, or -1 if none did
+    std::vector<long long> FixedStepEvaluations(Method method, const std::vector<double>& targets)
+    {
+        RungeKuttaSolver<double> rk;
+        std::vector<std::vector<double>> out;
+        std::vector<long long> evaluations(targets.size(), -1);
+
+        rk.SetMethod(method);
+        for (int power = 0; power < 20; power++)
+        {
+            rk.Solve(1.0, 2.0 / double(1L << power), 2.0, 0.0, GaussianExpression, out);
+            const double error = std::fabs(out.back()[1] - double(GaussianExact(2)));
+            for (size_t target = 0; target < targets.size(); target++)
+            {
+                if (evaluations[target] < 0 && error <= targets[target])
+                {
+                    evaluations[target] = rk.GetStats().evaluations;
+                }
+            }
+        }
+        return evaluations;
+    }
+
+    void PrintAdaptiveRow(const SolverStats& stats, double tolerance, double y)
+    {
+        std::cout << std::right << std::setw(12) << std::scientific << std::setprecision(0) << tolerance
+            << std::setw(12) << std::setprecision(2) << std::fabs(y - double(GaussianExact(2)))
+            << std::setw(8) << stats.steps << std::setw(10) << stats.rejectedSteps << std::setw(12) << stats.evaluations << "\n";
+    }
+
+    // RHS evaluations each method needs to reach a target error, fixed, adaptive and extrapolated
+    int MethodsBenchmark()
+    {
+        const std::vector<double> targets = { 1e-4, 1e-6, 1e-8, 1e-10 };
+        const Method methods[] =
+        {
+            Method::Euler, Method::Heun, Method::Rk3, Method::Rk4,
+            Method::ThreeEighths, Method::Rk5, Method::BogackiShampine, Method::DormandPrince,
+        };
+
+        std::cout << "RHS evaluations needed for |y(2) - exp(-4)| <= target in double, y' = " << GaussianExpression << ", y(0) = 1\n";
+        std::cout << "(- means the target was not reached)\n\nFixed step size (h halved until the target is met):\n";
+        std::cout << std::left << std::setw(10) << "method";
+        for (double target : targets)
+        {
+            std::cout << std::right << std::setw(10) << std::scientific << std::setprecision(0) << target;
+        }
+        std::cout << "\n";
+
+        for (Method method : methods)
+        {
+            VisitTableau(method, [](auto tableau) { std::cout << std::left << std::setw(10) << decltype(tableau)::Name; });
+            for (long long evaluations : FixedStepEvaluations(method, targets))
+            {
+                std::cout << std::right << std::setw(10);
+                if (evaluations < 0)
+                {
+                    std::cout << "-";
+                }
+                else
+                {
+                    std::cout << evaluations;
+                }
+            }
+            std::cout << "\n";
+        }
+
+        std::cout << "\nAdaptive step size with the embedded pairs (tolerance = target):\n";
+        std::cout << std::left << std::setw(10) << "method" << std::right << std::setw(12) << "tolerance" << std::setw(12) << "|error|"
+            << std::setw(8) << "steps" << std::setw(10) << "rejected" << std::setw(12) << "evaluations" << "\n";
+        for (Method method : { Method::BogackiShampine, Method::DormandPrince })
+        {
+            RungeKuttaSolver<double> rk;
+            std::vector<std::vector<double>> out;
+            rk.SetMethod(method);
+            for (double target : targets)
+            {
+                rk.SetTolerance(target);
+                rk.Solve(1.0, 0.1, 2.0, 0.0, GaussianExpression, out);
+                VisitTableau(method, [](auto tableau) { std::cout << std::left << std::setw(10) << decltype(tableau)::Name; });
+                PrintAdaptiveRow(rk.GetStats(), target, out.back()[1]);
+            }
+        }
+
+        std::cout << "\nExtrapolation (Gragg-Bulirsch-Stoer, tolerance = target):\n";
+        BulirschStoerSolver<double> gbs;
+        std::vector<std::vector<double>> out;
+        for (double target : targets)
+        {
+            gbs.SetTolerances(target, target);
+            gbs.Solve(1.0, 0.1, 2.0, 0.0, GaussianExpression, out);
+            std::cout << std::left << std::setw(10) << "gbs";
+            PrintAdaptiveRow(gbs.GetStats(), target, out.back()[1]);
+        }
+        return 0;
+    }
+
+    void PrintStiffRow(const char* label, const SolverStats& stats, double error, double seconds)
+    {
+        std::cout << std::left << std::setw(14) << label << std::right << std::setw(10) << stats.steps << std::setw(10) << stats.rejectedSteps
+            << std::setw(12) << stats.evaluations << std::setw(11) << stats.jacobianEvaluations << std::setw(9) << stats.factorizations
+            << std::setw(12) << std::scientific << std::setprecision(2) << error << std::setw(10) << std::fixed << std::setprecision(3) << seconds << "\n";
+    }
+
+    template <typename Solver>
+    void RunStiffSolver(const char* label, Solver& solver, const std::string& expr, double tf, double exact)
+    {
+        std::vector<std::vector<double>> out;
+        const auto start = std::chrono::steady_clock::now();
+        solver.Solve(0.0, 1e-4, tf, 0.0, expr, out);
+        const double seconds = SecondsSince(start);
+        PrintStiffRow(label, solver.GetStats(), std::fabs(out.back()[1] - exact), seconds);
+    }
+
+    // Explicit versus implicit solvers on y' = -lambda (y - cos t), which is stiff for large lambda
+    int StiffBenchmark()
+    {
+        const double tf = 10;
+        const double tolerance = 1e-6;
+
+        for (double lambda : { 1e3, 1e5 })
+        {
+            std::ostringstream expr;
+            expr << "-" << lambda << "*(y - cos(t))";
+            const double exact = (lambda * lambda * std::cos(tf) + lambda * std::sin(tf)) / (lambda * lambda + 1)
+                - lambda * lambda / (lambda * lambda + 1) * std::exp(-lambda * tf);
+
+            std::cout << std::defaultfloat << std::setprecision(6);
+            std::cout << "y' = " << expr.str() << ", y(0) = 0 over [0, " << tf << "], target error " << tolerance << "\n";
+            std::cout << std::left << std::setw(14) << "method" << std::right << std::setw(10) << "steps" << std::setw(10) << "rejected"
+                << std::setw(12) << "evaluations" << std::setw(11) << "jacobians" << std::setw(9) << "factors"
+                << std::setw(12) << "|error|" << std::setw(10) << "seconds" << "\n";
+
+            // Fixed-step RK4 with h halved until the target is met
+            {
+                RungeKuttaSolver<double> rk;
+                std::vector<std::vector<double>> out;
+                double h = 0.5, error = 0, seconds = 0;
+                do
+                {
+                    h /= 2;
+                    const auto start = std::chrono::steady_clock::now();
+                    rk.Solve(0.0, h, tf, 0.0, expr.str(), out);
+                    seconds = SecondsSince(start);
+                    error = std::fabs(out.back()[1] - exact);
+                } while (!(error <= tolerance) && h > 1e-7);
+                PrintStiffRow("rk4 (fixed)", rk.GetStats(), error, seconds);
+            }
+
+            RungeKuttaSolver<double> dopri;
+            dopri.SetMethod(Method::DormandPrince);
+            dopri.SetTolerance(tolerance);
+            RunStiffSolver("dopri5", dopri, expr.str(), tf, exact);
+
+            RosenbrockSolver<double> rosenbrock;
+            rosenbrock.SetTolerances(tolerance, tolerance);
+            RunStiffSolver("rosenbrock", rosenbrock, expr.str(), tf, exact);
+
+            BdfSolver<double> bdf;
+            bdf.SetTolerances(tolerance, tolerance);
+            RunStiffSolver("bdf", bdf, expr.str(), tf, exact);
+            std::cout << "\n";
+        }
+        return 0;
+    }
+
+    // Auto-switching versus single-method solvers on a problem with stiff and non-stiff phases
+    int SwitchingBenchmark()
+    {
+        // Stiffness 5000 sin(t)^8 peaks near odd multiples of pi/2 and vanishes in between
+        const std::string expr = "-(0.5 + 5000*sin(t)^8)*(y - cos(t))";
+        const double tf = 20;
+        const double tolerance = 1e-6;
+
+        RungeKuttaSolver<double> reference;
+        std::vector<std::vector<double>> out;
+        reference.SetMethod(Method::DormandPrince);
+        reference.SetTolerance(1e-13);
+        reference.Solve(0.0, 1e-4, tf, 0.0, expr, out);
+        const double exact = out.back()[1];
+
+        std::cout << "y' = " << expr << ", y(0) = 0 over [0, " << tf << "], tolerance " << tolerance << "\n";
+        std::cout << std::left << std::setw(14) << "method" << std::right << std::setw(10) << "steps" << std::setw(10) << "rejected"
+            << std::setw(12) << "evaluations" << std::setw(11) << "jacobians" << std::setw(9) << "factors"
+            << std::setw(12) << "|error|" << std::setw(10) << "seconds" << "\n";
+
+        RungeKuttaSolver<double> dopri;
+        dopri.SetMethod(Method::DormandPrince);
+        dopri.SetTolerance(tolerance);
+        RunStiffSolver("dopri5", dopri, expr, tf, exact);
+
+        RosenbrockSolver<double> rosenbrock;
+        rosenbrock.SetTolerances(tolerance, tolerance);
+        RunStiffSolver("rosenbrock", rosenbrock, expr, tf, exact);
+
+        BdfSolver<double> bdf;
+        bdf.SetTolerances(tolerance, tolerance);
+        RunStiffSolver("bdf", bdf, expr, tf, exact);
+
+        AutoSwitchingSolver<double> automatic;
+        automatic.SetTolerances(tolerance, tolerance);
+        RunStiffSolver("auto", automatic, expr, tf, exact);
+
+        const RegimeStats<double>& regimes = automatic.GetRegimeStats();
+        std::cout << "\nauto: " << regimes.explicitSteps << " explicit steps, " << regimes.implicitSteps << " implicit steps, "
+            << regimes.switchTimes.size() << " switches at t =";
+        for (double time : regimes.switchTimes)
+        {
+            std::cout << " " << std::setprecision(2) << time;
+        }
+        std::cout << "\n";
+        return 0;
+    }
+
+    template <typename Solver>
+    void PrintMultistepRow(const char* label, Solver& solver, double h)
+    {
+        std::vector<std::vector<double>> out;
+        const auto start = std::chrono::steady_clock::now();
+        solver.Solve(1.0, h, 2.0, 0.0, GaussianExpression, out);
+        const double seconds = SecondsSince(start);
+
+        std::cout << std::left << std::setw(10) << label << std::right << std::setw(10) << std::defaultfloat << h
+            << std::setw(12) << solver.GetStats().evaluations << std::setw(12) << std::scientific << std::setprecision(2)
+            << std::fabs(out.back()[1] - double(GaussianExact(2))) << std::setw(10) << std::fixed << std::setprecision(4) << seconds << "\n";
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+
+    // Evaluations and error of Adams-Bashforth-Moulton versus RK4 on the same step sizes
+    int MultistepBenchmark()
+    {
+        std::cout << "y' = " << GaussianExpression << ", y(0) = 1 over [0, 2]\n";
+        std::cout << std::left << std::setw(10) << "method" << std::right << std::setw(10) << "h" << std::setw(12) << "evaluations"
+            << std::setw(12) << "|error|" << std::setw(10) << "seconds" << "\n";
+
+        for (double h : { 1e-2, 1e-3, 1e-4 })
+        {
+            RungeKuttaSolver<double> rk;
+            PrintMultistepRow("rk4", rk, h);
+
+            AdamsBashforthMoultonSolver<double> pece;
+            PrintMultistepRow("abm", pece, h);
+
+            AdamsBashforthMoultonSolver<double> pec;
+            pec.SetMode(AdamsMode::Pec);
+            PrintMultistepRow("abm-pec", pec, h);
+        }
+        return 0;
+    }
+
+    void PrintTaylorRow(const char* label, double target, const SolverStats& stats, double error, double seconds)
+    {
+        std::cout << std::left << std::setw(8) << label << std::right << std::setw(10) << std::scientific << std::setprecision(0) << target
+            << std::setw(10) << stats.steps << std::setw(12) << stats.evaluations << std::setw(12) << std::setprecision(2) << error
+            << std::setw(10) << std::fixed << std::setprecision(4) << seconds << "\n";
+    }
+
+    // Adaptive-order Taylor series versus fixed-step RK4 on smooth problems
+    int TaylorBenchmark()
+    {
+        struct Problem
+        {
+            const char* expr;
+            double tf;
+            double exact;
+        };
+        const Problem problems[] =
+        {
+            { GaussianExpression, 2, double(GaussianExact(2)) },
+            { "y*cos(t) + sin(t)^2 - y^2*exp(-t)/(1 + y^2)", 10, 0 },
+        };
+
+        for (const Problem& problem : problems)
+        {
+            double exact = problem.exact;
+            if (exact == 0)
+            {
+                RungeKuttaSolver<double> reference;
+                std::vector<std::vector<double>> out;
+                reference.SetMethod(Method::DormandPrince);
+                reference.SetTolerance(1e-14);
+                reference.Solve(1.0, 1e-3, problem.tf, 0.0, problem.expr, out);
+                exact = out.back()[1];
+            }
+
+            std::cout << std::defaultfloat << std::setprecision(6);
+            std::cout << "y' = " << problem.expr << ", y(0) = 1 over [0, " << problem.tf << "]\n";
+            std::cout << std::left << std::setw(8) << "method" << std::right << std::setw(10) << "target" << std::setw(10) << "steps"
+                << std::setw(12) << "evaluations" << std::setw(12) << "|error|" << std::setw(10) << "seconds" << "\n";
+
+            for (double target : { 1e-6, 1e-10, 1e-13 })
+            {
+                // Fixed-step RK4 with h halved until the target is met
+                RungeKuttaSolver<double> rk;
+                std::vector<std::vector<double>> out;
+                double h = 1, error = 0, seconds = 0;
+                do
+                {
+                    h /= 2;
+                    const auto start = std::chrono::steady_clock::now();
+                    rk.Solve(1.0, h, problem.tf, 0.0, problem.expr, out);
+                    seconds = SecondsSince(start);
+                    error = std::fabs(out.back()[1] - exact);
+                } while (!(error <= target) && h > 1e-6);
+                PrintTaylorRow("rk4", target, rk.GetStats(), error, seconds);
+
+                TaylorSolver<double> taylor;
+                taylor.SetTolerances(target, target);
+                const auto start = std::chrono::steady_clock::now();
+                taylor.Solve(1.0, problem.tf, problem.tf, 0.0, problem.expr, out);
+                seconds = SecondsSince(start);
+                PrintTaylorRow("taylor", target, taylor.GetStats(), std::fabs(out.back()[1] - exact), seconds);
+            }
+            std::cout << "\n";
+        }
+        std::cout << "(a Taylor evaluation is one pass over the expression for one order of the series)\n";
+        return 0;
+    }
+
+    double MaxGaussianError(const std::vector<std::vector<double>>& out)
+    {
+        double worst = 0;
+        for (const std::vector<double>& row : out)
+        {
+            worst = std::max(worst, std::fabs(row[1] - double(GaussianExact(row[0]))));
+        }
+        return worst;
+    }
+
+    void PrintDenseRow(const char* label, const RungeKuttaSolver<double>& rk, const std::vector<std::vector<double>>& out, double seconds)
+    {
+        std::cout << std::left << std::setw(26) << label << std::right << std::setw(8) << rk.GetStats().steps
+            << std::setw(12) << rk.GetStats().evaluations << std::setw(8) << out.size()
+            << std::setw(12) << std::scientific << std::setprecision(2) << MaxGaussianError(out)
+            << std::setw(10) << std::fixed << std::setprecision(4) << seconds << "\n";
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+
+    // Output every 0.001 from the step grid itself versus dense output from larger steps
+    int DenseBenchmark()
+    {
+        const double outputStep = 1e-3;
+        const std::vector<double> grid = UniformGrid(0.0, 2.0, outputStep);
+
+        std::cout << "y' = " << GaussianExpression << ", y(0) = 1 over [0, 2], output every " << outputStep << "\n";
+        std::cout << std::left << std::setw(26) << "method" << std::right << std::setw(8) << "steps" << std::setw(12) << "evaluations"
+            << std::setw(8) << "rows" << std::setw(12) << "max |error|" << std::setw(10) << "seconds" << "\n";
+
+        RungeKuttaSolver<double> rk;
+        std::vector<std::vector<double>> out;
+        auto start = std::chrono::steady_clock::now();
+        rk.Solve(1.0, outputStep, 2.0, 0.0, GaussianExpression, out);
+        PrintDenseRow("rk4, h = output step", rk, out, SecondsSince(start));
+
+        for (double h : { 0.1, 0.05, 0.01 })
+        {
+            std::ostringstream label;
+            label << "rk4, h = " << h << ", dense";
+            start = std::chrono::steady_clock::now();
+            rk.SolveOnGrid(1.0, h, grid, GaussianExpression, out);
+            PrintDenseRow(label.str().c_str(), rk, out, SecondsSince(start));
+        }
+
+        rk.SetMethod(Method::DormandPrince);
+        for (double tolerance : { 1e-6, 1e-9 })
+        {
+            std::ostringstream label;
+            label << "dopri5, tol " << tolerance << ", dense";
+            rk.SetTolerance(tolerance);
+            start = std::chrono::steady_clock::now();
+            rk.SolveOnGrid(1.0, 0.1, grid, GaussianExpression, out);
+            PrintDenseRow(label.str().c_str(), rk, out, SecondsSince(start));
+        }
+        return 0;
+    }
+
+    void PrintEventRow(const char* label, RungeKuttaSolver<double>& rk, const char* expr, double tf, double eventTime)
+    {
+        std::vector<std::vector<double>> out;
+        const auto start = std::chrono::steady_clock::now();
+        rk.Solve(1.0, 0.01, tf, 0.0, expr, out);
+        const double seconds = SecondsSince(start);
+
+        std::cout << std::left << std::setw(26) << label << std::right << std::setw(10) << out.back()[0]
+            << std::setw(12) << rk.GetStats().evaluations << std::setw(12) << std::scientific << std::setprecision(2);
+        if (rk.GetEvents().empty())
+        {
+            std::cout << "-";
+        }
+        else
+        {
+            std::cout << std::fabs(rk.GetEvents().back().t - eventTime);
+        }
+        std::cout << std::setw(10) << std::fixed << std::setprecision(4) << seconds << "\n";
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+
+    // Evaluations saved by stopping at a terminal event instead of integrating to tf
+    int EventsBenchmark()
+    {
+        // The logistic curve y = K / (1 + (K - 1) exp(-t)) crosses K / 2 at t = ln(K - 1)
+        const char* expr = "y*(1 - y/1000)";
+        const char* event = "y - 500";
+        const double tf = 100;
+        const double eventTime = std::log(999.0);
+
+        std::cout << "y' = " << expr << ", y(0) = 1 over [0, " << tf << "], stop event " << event << " (exact t = " << eventTime << ")\n";
+        std::cout << std::left << std::setw(26) << "method" << std::right << std::setw(10) << "end t" << std::setw(12) << "evaluations"
+            << std::setw(12) << "|t error|" << std::setw(10) << "seconds" << "\n";
+
+        for (Method method : { Method::Rk4, Method::DormandPrince })
+        {
+            const bool adaptive = method == Method::DormandPrince;
+            RungeKuttaSolver<double> rk;
+            rk.SetMethod(method);
+            rk.SetTolerance(adaptive ? 1e-9 : 0);
+            PrintEventRow(adaptive ? "dopri5, to tf" : "rk4 h = 0.01, to tf", rk, expr, tf, eventTime);
+
+            rk.AddEvent(event, EventAction::Terminate);
+            PrintEventRow(adaptive ? "dopri5, stop event" : "rk4 h = 0.01, stop event", rk, expr, tf, eventTime);
+        }
+        return 0;
+    }
+
+    void PrintSteadyRow(const char* label, RungeKuttaSolver<double>& rk, const char* expr, double tf, double steady)
+    {
+        std::vector<std::vector<double>> out;
+        const auto start = std::chrono::steady_clock::now();
+        rk.Solve(0.0, 0.01, tf, 0.0, expr, out);
+        const double seconds = SecondsSince(start);
+
+        const SteadyStateStats<double>& settled = rk.GetSteadyStateStats();
+        std::cout << std::left << std::setw(24) << label << std::right << std::setw(10) << out.size()
+            << std::setw(12) << rk.GetStats().evaluations << std::setw(10) << (settled.reached ? settled.time : tf)
+            << std::setw(10) << settled.skippedTime << std::setw(10) << settled.stepsSkipped
+            << std::setw(12) << std::scientific << std::setprecision(2) << std::fabs(out.back()[1] - steady)
+            << std::setw(10) << std::fixed << std::setprecision(4) << seconds << "\n";
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+
+    // Evaluations saved by stopping a relaxation once it reaches equilibrium
+    int SteadyStateBenchmark()
+    {
+        const char* expr = "2 - y + exp(-t)*sin(5*t)";
+        const double tf = 1000;
+        const double steady = 2;
+
+        SteadyStateOptions<double> options;
+        options.enabled = true;
+        options.derivativeTolerance = 1e-8;
+        options.changeTolerance = 1e-8;
+
+        std::cout << "y' = " << expr << ", y(0) = 0 over [0, " << tf << "], steady tolerance " << options.derivativeTolerance
+            << " over " << options.window << " steps\n";
+        std::cout << std::left << std::setw(24) << "method" << std::right << std::setw(10) << "rows" << std::setw(12) << "evaluations"
+            << std::setw(10) << "end t" << std::setw(10) << "skipped t" << std::setw(10) << "skipped" << std::setw(12) << "|y - 2|"
+            << std::setw(10) << "seconds" << "\n";
+
+        for (Method method : { Method::Rk4, Method::DormandPrince })
+        {
+            const bool adaptive = method == Method::DormandPrince;
+            RungeKuttaSolver<double> rk;
+            rk.SetMethod(method);
+            rk.SetTolerance(adaptive ? 1e-10 : 0);
+            PrintSteadyRow(adaptive ? "dopri5" : "rk4 h = 0.01", rk, expr, tf, steady);
+
+            rk.SetSteadyState(options);
+            PrintSteadyRow(adaptive ? "dopri5, fill" : "rk4 h = 0.01, fill", rk, expr, tf, steady);
+
+            options.output = SteadyStateOutput::Truncate;
+            rk.SetSteadyState(options);
+            PrintSteadyRow(adaptive ? "dopri5, truncate" : "rk4 h = 0.01, truncate", rk, expr, tf, steady);
+            options.output = SteadyStateOutput::Fill;
+        }
+        return 0;
+    }
+
+    // Parareal on a long trajectory versus the serial fine RK4 it reproduces
+    int PararealBenchmark()
+    {
+        const char* expr = "-y + sin(t)*cos(3*t)";
+        const double tf = 50;
+        const double h = 1e-4;
+
+        RungeKuttaSolver<double> serial;
+        std::vector<std::vector<double>> reference;
+        auto start = std::chrono::steady_clock::now();
+        serial.Solve(0.0, h, tf, 0.0, expr, reference);
+        const double serialSeconds = SecondsSince(start);
+
+        PararealSolver<double> parareal;
+        std::cout << "y' = " << expr << ", y(0) = 0 over [0, " << tf << "] with h = " << h << ", "
+            << std::thread::hardware_concurrency() << " hardware threads\n";
+        std::cout << "serial rk4: " << serial.GetStats().evaluations << " evaluations, " << std::fixed << std::setprecision(3)
+            << serialSeconds << " s\n\n" << std::defaultfloat;
+        std::cout << std::setw(7) << "slices" << std::setw(7) << "ratio" << std::setw(11) << "iterations" << std::setw(12) << "evaluations"
+            << std::setw(15) << "critical path" << std::setw(15) << "model speedup" << std::setw(10) << "seconds"
+            << std::setw(9) << "speedup" << std::setw(12) << "max |diff|" << "\n";
+
+        for (int slices : { 4, 8, 16, 32 })
+        {
+            for (int ratio : { 100, 1000 })
+            {
+                std::vector<std::vector<double>> out;
+                parareal.SetSlices(slices);
+                parareal.SetCoarseRatio(ratio);
+                start = std::chrono::steady_clock::now();
+                parareal.Solve(0.0, h, tf, 0.0, expr, out);
+                const double seconds = SecondsSince(start);
+
+                double difference = 0;
+                for (size_t row = 0; row < out.size(); row++)
+                {
+                    difference = std::max(difference, std::fabs(out[row][1] - reference[row][1]));
+                }
+
+                const PararealStats<double>& stats = parareal.GetPararealStats();
+                std::cout << std::setw(7) << stats.slices << std::setw(7) << ratio << std::setw(11) << stats.iterations
+                    << std::setw(12) << parareal.GetStats().evaluations << std::setw(15) << stats.criticalPathEvaluations
+                    << std::setw(15) << std::fixed << std::setprecision(2) << double(serial.GetStats().evaluations) / stats.criticalPathEvaluations
+                    << std::setw(10) << std::setprecision(3) << seconds << std::setw(9) << std::setprecision(2) << serialSeconds / seconds
+                    << std::setw(12) << std::scientific << difference << "\n" << std::defaultfloat;
+            }
+        }
+        std::cout << "\n(model speedup assumes one core per slice: serial evaluations over the critical path)\n";
+        return 0;
+    }
+
+    // Load balance of work stealing versus a static split on an ensemble whose
+    // members' final times grow steeply with their index
+    int EnsembleBenchmark()
+    {
+        const char* expr = "-y + sin(t)";
+        const int threads = 4;
+        const int count = 256;
+
+        std::vector<EnsembleMember<double>> members(count);
+        for (int m = 0; m < count; m++)
+        {
+            const double u = double(m) / (count - 1);
+            members[m] = { 1.0, 1e-3, 0.0, 1 + 99 * u * u * u };
+        }
+
+        std::cout << count << " members of y' = " << expr << " with t_f from 1 to 100 (cubic in the member index), "
+            << threads << " workers on " << std::thread::hardware_concurrency() << " hardware threads\n";
+        std::cout << "(imbalance is the busiest worker's evaluations over the mean, 1 is perfect)\n\n";
+        std::cout << std::left << std::setw(16) << "schedule" << std::right << std::setw(7) << "chunk" << std::setw(11) << "imbalance"
+            << std::setw(8) << "steals" << std::setw(10) << "seconds" << "   evaluations per worker\n";
+
+        // The first run allocates the trajectories, so it is left out of the timings
+        EnsembleSolver<double> ensemble(threads);
+        std::vector<std::vector<std::vector<double>>> out;
+        ensemble.Solve(members, expr, out);
+
+        struct Schedule
+        {
+            const char* label;
+            bool stealing;
+            int chunk;
+        };
+        const Schedule schedules[] =
+        {
+            { "static", false, count / threads },
+            { "static", false, 1 },
+            { "work stealing", true, 16 },
+            { "work stealing", true, 4 },
+            { "work stealing", true, 1 },
+        };
+
+        for (const Schedule& schedule : schedules)
+        {
+            ensemble.SetStealing(schedule.stealing);
+            ensemble.SetChunkSize(schedule.chunk);
+            const auto start = std::chrono::steady_clock::now();
+            ensemble.Solve(members, expr, out);
+            const double seconds = SecondsSince(start);
+
+            const std::vector<long long>& evaluations = ensemble.GetWorkerEvaluations();
+            long long busiest = 0, steals = 0;
+            for (int worker = 0; worker < threads; worker++)
+            {
+                busiest = std::max(busiest, evaluations[worker]);
+                steals += ensemble.GetSchedulerStats().steals[worker];
+            }
+            const double mean = double(ensemble.GetStats().evaluations) / threads;
+
+            std::cout << std::left << std::setw(16) << schedule.label << std::right << std::setw(7) << schedule.chunk
+                << std::setw(11) << std::fixed << std::setprecision(2) << busiest / mean << std::setw(8) << steals
+                << std::setw(10) << std::setprecision(3) << seconds << "  " << std::defaultfloat;
+            for (long long workerEvaluations : evaluations)
+            {
+                std::cout << " " << workerEvaluations;
+            }
+            std::cout << "\n";
+        }
+        return 0;
+    }
+
+    // Members of an ensemble advanced per second on one core, exprtk one
+    // member at a time versus the lane-batched evaluator at each SIMD level
+    int SimdBenchmark()
+    {
+        const int count = 1024;
+        const double tf = 10;
+        const double h = 1e-2;
+        const char* expressions[] = { "-y + y*y*t/(1 + t*t) - 0.5*t", "-y + sin(t)" };
+
+        std::vector<EnsembleMember<double>> members(count);
+        for (int m = 0; m < count; m++)
+        {
+            members[m] = { 0.5 + double(m) / count, h, 0.0, tf };
+        }
+
+        std::cout << count << " members, fixed-step RK4 with h = " << h << " to t = " << tf << ", one thread, "
+            << BatchedEnsembleSolver<double>::Lanes << " lanes per block, CPU supports " << SimdLevelName(DetectSimdLevel()) << "\n";
+        std::cout << "(rate is member steps per second; difference is the largest |y(t_f)| difference from exprtk)\n";
+
+        for (const char* expr : expressions)
+        {
+            std::cout << "\ny' = " << expr << "\n";
+            std::cout << std::left << std::setw(12) << "evaluator" << std::right << std::setw(10) << "seconds"
+                << std::setw(14) << "rate" << std::setw(10) << "speedup" << std::setw(13) << "difference" << "\n";
+
+            EnsembleSolver<double> ensemble(1);
+            ensemble.SetChunkSize(count);
+            std::vector<std::vector<std::vector<double>>> trajectories;
+            ensemble.Solve(members, expr, trajectories);
+            auto start = std::chrono::steady_clock::now();
+            ensemble.Solve(members, expr, trajectories);
+            const double scalarSeconds = SecondsSince(start);
+            const double steps = double(ensemble.GetStats().steps);
+
+            std::cout << std::left << std::setw(12) << "exprtk" << std::right << std::fixed << std::setprecision(4)
+                << std::setw(10) << scalarSeconds << std::scientific << std::setprecision(2) << std::setw(14) << steps / scalarSeconds
+                << std::fixed << std::setw(10) << 1.0 << std::setw(13) << "" << std::defaultfloat << std::setprecision(6) << "\n";
+
+            const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512 };
+            for (SimdLevel level : levels)
+            {
+                if (level > DetectSimdLevel())
+                {
+                    continue;
+                }
+
+                BatchedEnsembleSolver<double> batched(1);
+                batched.SetSimdLevel(level);
+                std::vector<std::vector<double>> finals;
+                batched.Solve(members, expr, finals);
+                start = std::chrono::steady_clock::now();
+                batched.Solve(members, expr, finals);
+                const double seconds = SecondsSince(start);
+
+                double difference = 0;
+                for (int m = 0; m < count; m++)
+                {
+                    difference = std::max(difference, std::fabs(finals[m][1] - trajectories[m].back()[1]));
+                }
+
+                std::cout << std::left << std::setw(12) << SimdLevelName(level) << std::right << std::fixed << std::setprecision(4)
+                    << std::setw(10) << seconds << std::scientific << std::setprecision(2) << std::setw(14) << steps / seconds
+                    << std::fixed << std::setw(10) << scalarSeconds / seconds << std::scientific << std::setw(13) << difference
+                    << std::defaultfloat << std::setprecision(6) << "\n";
+            }
+        }
+        return 0;
+    }
+
+    // A sweep over a rate constant by editing the expression text, which
+    // recompiles it every run, versus a named parameter updated in place
+    int SweepBenchmark()
+    {
+        const int count = 200;
+        const double h = 1e-2;
+        const double tf = 1;
+        std::vector<double> rates(count);
+        for (int run = 0; run < count; run++)
+        {
+            rates[run] = 0.1 + 0.01 * run;
+        }
+
+        std::cout << count << " runs of y' = -k*y + a*sin(w*t) over k, fixed-step RK4 with h = " << h << " to t = " << tf << "\n\n";
+        std::cout << std::left << std::setw(24) << "sweep" << std::right << std::setw(10) << "seconds"
+            << std::setw(14) << "per run (us)" << std::setw(13) << "difference" << "\n";
+
+        RungeKuttaSolver<double> substituted;
+        std::vector<std::vector<std::vector<double>>> substitutedOut(count);
+        auto start = std::chrono::steady_clock::now();
+        for (int run = 0; run < count; run++)
+        {
+            std::ostringstream expr;
+            expr << std::setprecision(17) << "-" << rates[run] << "*y + 0.3*sin(2*t)";
+            substituted.Solve(1.0, h, tf, 0.0, expr.str(), substitutedOut[run]);
+        }
+        const double substitutedSeconds = SecondsSince(start);
+
+        RungeKuttaSolver<double> swept;
+        swept.SetParameter("a", 0.3);
+        swept.SetParameter("w", 2);
+        std::vector<std::vector<std::vector<double>>> sweptOut;
+        start = std::chrono::steady_clock::now();
+        swept.SolveSweep(1.0, h, tf, 0.0, "-k*y + a*sin(w*t)", "k", rates, sweptOut);
+        const double sweptSeconds = SecondsSince(start);
+
+        double difference = 0;
+        for (int run = 0; run < count; run++)
+        {
+            difference = std::max(difference, std::fabs(sweptOut[run].back()[1] - substitutedOut[run].back()[1]));
+        }
+
+        std::cout << std::fixed << std::left << std::setw(24) << "recompiled per value" << std::right << std::setprecision(4)
+            << std::setw(10) << substitutedSeconds << std::setprecision(1) << std::setw(14) << 1e6 * substitutedSeconds / count << "\n";
+        std::cout << std::left << std::setw(24) << "parameter in place" << std::right << std::setprecision(4)
+            << std::setw(10) << sweptSeconds << std::setprecision(1) << std::setw(14) << 1e6 * sweptSeconds / count
+            << std::scientific << std::setprecision(2) << std::setw(13) << difference << std::defaultfloat << std::setprecision(6) << "\n";
+        return 0;
+    }
+
+    // A grid over a rate constant and the initial value, run as separate
+    // Solve calls that keep every trajectory versus the sweep engine, which
+    // reduces each trajectory as it streams and writes summaries to a file
+    int GridBenchmark()
+    {
+        const int rates = 64;
+        const int starts = 64;
+        const double h = 1e-2;
+        const double tf = 5;
+        const char* expr = "-k*y + sin(t)";
+        const char* path = "sweep_benchmark.rkcf";
+
+        std::cout << rates << " x " << starts << " grid over k and y0 of y' = " << expr << ", fixed-step RK4 with h = " << h
+            << " to t = " << tf << ", event y = 0.5, " << std::thread::hardware_concurrency() << " hardware threads\n\n";
+        std::cout << std::left << std::setw(26) << "sweep" << std::right << std::setw(10) << "seconds" << std::setw(16) << "rows held" << "\n";
+
+        RungeKuttaSolver<double> rk;
+        rk.AddEvent("y - 0.5", EventAction::Record);
+        std::vector<std::vector<std::vector<double>>> trajectories(rates * starts);
+        auto start = std::chrono::steady_clock::now();
+        size_t rowsHeld = 0;
+        for (int r = 0; r < rates; r++)
+        {
+            for (int s = 0; s < starts; s++)
+            {
+                rk.SetParameter("k", 0.1 + 1.9 * r / (rates - 1));
+                std::vector<std::vector<double>>& out = trajectories[r * starts + s];
+                rk.Solve(-1 + 2.0 * s / (starts - 1), h, tf, 0.0, expr, out);
+                rowsHeld += out.size();
+            }
+        }
+        std::cout << std::left << std::setw(26) << "separate Solve calls" << std::right << std::fixed << std::setprecision(4)
+            << std::setw(10) << SecondsSince(start) << std::setw(16) << rowsHeld << std::defaultfloat << "\n";
+
+        const int threadCounts[] = { 1, 4 };
+        for (int threads : threadCounts)
+        {
+            SweepEngine<double> sweep(threads);
+            sweep.AddAxis({ "k", 0.1, 2.0, rates });
+            sweep.AddAxis({ "y0", -1.0, 1.0, starts });
+            sweep.AddEvent("y - 0.5", EventAction::Record);
+            sweep.SetGroupSize(1024);
+            start = std::chrono::steady_clock::now();
+            sweep.Run(0.0, h, tf, 0.0, expr, path);
+            const double seconds = SecondsSince(start);
+
+            std::vector<std::string> names;
+            std::vector<std::vector<double>> columns;
+            if (!ReadColumnarFile(path, names, columns) || columns[0].size() != size_t(rates * starts))
+            {
+                std::cerr << "Sweep output could not be read back\n";
+                return 1;
+            }
+
+            // Compare the final values with the separate runs
+            double difference = 0;
+            for (size_t point = 0; point < columns[0].size(); point++)
+            {
+                difference = std::max(difference, std::fabs(columns[3][point] - trajectories[point].back()[1]));
+            }
+
+            std::ostringstream label;
+            label << "sweep engine, " << threads << (threads == 1 ? " thread" : " threads");
+            std::cout << std::left << std::setw(26) << label.str() << std::right << std::fixed << std::setprecision(4)
+                << std::setw(10) << seconds << std::setw(16) << threads * SweepEngine<double>::BatchRows << std::defaultfloat
+                << "   " << columns[0].size() << " rows of " << names.size() << " columns, max difference " << difference << "\n";
+        }
+        std::remove(path);
+        return 0;
+    }
+
+    // dy/dk, dy/da and dy/dy0 of y' = -k*y + a from the forward sensitivity
+    // equations in one pass versus central differences of repeated solves,
+    // both against the exact derivatives of y = a/k + (y0 - a/k) exp(-k t)
+    int SensitivityBenchmark()
+    {
+        const double k = 0.8, a = 0.5, y0 = 2;
+        const double h = 1e-2, tf = 5;
+        const char* expr = "-k*y + a";
+
+        auto exact = [&](double t, double* derivatives)
+        {
+            const double decay = std::exp(-k * t);
+            derivatives[0] = -a / (k * k) * (1 - decay) - t * (y0 - a / k) * decay;
+            derivatives[1] = (1 - decay) / k;
+            derivatives[2] = decay;
+        };
+
+        std::cout << "y' = " << expr << " with k = " << k << ", a = " << a << ", y0 = " << y0 << ", fixed-step RK4 with h = " << h
+            << " to t = " << tf << "\n(errors are the largest over the trajectory)\n\n";
+        std::cout << std::left << std::setw(22) << "method" << std::right << std::setw(12) << "evaluations" << std::setw(10) << "seconds"
+            << std::setw(12) << "dy/dk" << std::setw(12) << "dy/da" << std::setw(12) << "dy/dy0" << "\n";
+
+        auto printRow = [](const char* label, long long evaluations, double seconds, const double* errors)
+        {
+            std::cout << std::left << std::setw(22) << label << std::right << std::setw(12) << evaluations << std::fixed
+                << std::setprecision(4) << std::setw(10) << seconds << std::scientific << std::setprecision(2);
+            for (int p = 0; p < 3; p++)
+            {
+                std::cout << std::setw(12) << errors[p];
+            }
+            std::cout << std::defaultfloat << std::setprecision(6) << "\n";
+        };
+
+        SensitivitySolver<double> forward;
+        forward.SetParameter("k", k);
+        forward.SetParameter("a", a);
+        forward.SetInitialValueSensitivity(true);
+        std::vector<std::vector<double>> out;
+        auto start = std::chrono::steady_clock::now();
+        forward.Solve(y0, h, tf, 0.0, expr, out);
+        double seconds = SecondsSince(start);
+
+        double errors[3] = { 0, 0, 0 };
+        double derivatives[3];
+        for (const std::vector<double>& row : out)
+        {
+            exact(row[0], derivatives);
+            for (int p = 0; p < 3; p++)
+            {
+                errors[p] = std::max(errors[p], std::fabs(row[2 + p] - derivatives[p]));
+            }
+        }
+        printRow("forward sensitivity", forward.GetStats().evaluations, seconds, errors);
+
+        // Central differences with a step balancing truncation and rounding
+        RungeKuttaSolver<double> rk;
+        const double nominal[3] = { k, a, y0 };
+        const char* names[2] = { "k", "a" };
+        std::vector<std::vector<double>> plus, minus;
+        long long evaluations = 0;
+        start = std::chrono::steady_clock::now();
+        std::vector<std::vector<double>> differences(out.size(), std::vector<double>(3));
+        for (int p = 0; p < 3; p++)
+        {
+            const double delta = std::cbrt(std::numeric_limits<double>::epsilon()) * std::max(1.0, std::fabs(nominal[p]));
+            for (int sign = -1; sign <= 1; sign += 2)
+            {
+                double values[3] = { k, a, y0 };
+                values[p] += sign * delta;
+                rk.SetParameter(names[0], values[0]);
+                rk.SetParameter(names[1], values[1]);
+                rk.Solve(values[2], h, tf, 0.0, expr, sign < 0 ? minus : plus);
+                evaluations += rk.GetStats().evaluations;
+            }
+            for (size_t row = 0; row < out.size(); row++)
+            {
+                differences[row][p] = (plus[row][1] - minus[row][1]) / (2 * delta);
+            }
+        }
+        seconds = SecondsSince(start);
+
+        std::fill(errors, errors + 3, 0.0);
+        for (size_t row = 0; row < out.size(); row++)
+        {
+            exact(out[row][0], derivatives);
+            for (int p = 0; p < 3; p++)
+            {
+                errors[p] = std::max(errors[p], std::fabs(differences[row][p] - derivatives[p]));
+            }
+        }
+        printRow("central differences", evaluations, seconds, errors);
+        return 0;
+    }
+
+    // Gradient of y(t_f)^2 for y' = -k*y + sum a_j sin(j t) in all the
+    // parameters, by the adjoint method versus forward sensitivities, and the
+    // recomputation the adjoint pays for smaller checkpoint budgets
+    int AdjointBenchmark()
+    {
+        const double h = 1e-2, tf = 10;
+        const long long steps = (long long)std::ceil(tf / h);
+
+        auto forcedDecay = [](int terms)
+        {
+            std::ostringstream expr;
+            expr << "-k*y";
+            for (int j = 1; j <= terms; j++)
+            {
+                expr << " + a" << j << "*sin(" << j << "*t)";
+            }
+            return expr.str();
+        };
+
+        std::cout << "y' = -k*y + a1*sin(t) + .. + an*sin(n*t), J = y(t_f)^2, fixed-step RK4 with h = " << h << " to t = " << tf << "\n\n";
+        std::cout << std::left << std::setw(12) << "parameters" << std::right << std::setw(14) << "adjoint (s)" << std::setw(14)
+            << "forward (s)" << std::setw(16) << "max difference" << "\n";
+
+        const int termCounts[] = { 4, 16, 64 };
+        for (int terms : termCounts)
+        {
+            const std::string expr = forcedDecay(terms);
+            AdjointSolver<double> adjoint;
+            SensitivitySolver<double> forward;
+            adjoint.SetParameter("k", 0.5);
+            forward.SetParameter("k", 0.5);
+            for (int j = 1; j <= terms; j++)
+            {
+                adjoint.SetParameter("a" + std::to_string(j), 1.0 / j);
+                forward.SetParameter("a" + std::to_string(j), 1.0 / j);
+            }
+            forward.SetInitialValueSensitivity(true);
+            adjoint.SetObjective("", "y^2");
+
+            std::vector<double> gradient;
+            auto start = std::chrono::steady_clock::now();
+            adjoint.Solve(1.0, h, tf, 0.0, expr, gradient);
+            const double adjointSeconds = SecondsSince(start);
+
+            std::vector<std::vector<double>> out;
+            start = std::chrono::steady_clock::now();
+            forward.Solve(1.0, h, tf, 0.0, expr, out);
+            const double forwardSeconds = SecondsSince(start);
+
+            // dJ/dp = 2 y(t_f) dy/dp
+            const std::vector<double>& last = out.back();
+            double difference = 0;
+            for (size_t p = 0; p < gradient.size(); p++)
+            {
+                difference = std::max(difference, std::fabs(gradient[p] - 2 * last[1] * last[2 + p]));
+            }
+
+            std::cout << std::left << std::setw(12) << terms + 1 << std::right << std::fixed << std::setprecision(4)
+                << std::setw(14) << adjointSeconds << std::setw(14) << forwardSeconds << std::scientific << std::setprecision(2)
+                << std::setw(16) << difference << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+
+        std::cout << "\n" << steps << " steps, 17 parameters, J = integral of y^2 + y(t_f)^2\n";
+        std::cout << std::left << std::setw(10) << "budget" << std::right << std::setw(13) << "checkpoints" << std::setw(9) << "segment"
+            << std::setw(13) << "peak states" << std::setw(13) << "recomputed" << std::setw(10) << "seconds" << "\n";
+
+        const std::string expr = forcedDecay(16);
+        const long long budgets[] = { 0, 200, 2 * (long long)std::ceil(std::sqrt(double(steps))), 20 };
+        for (long long budget : budgets)
+        {
+            AdjointSolver<double> adjoint;
+            adjoint.SetParameter("k", 0.5);
+            for (int j = 1; j <= 16; j++)
+            {
+                adjoint.SetParameter("a" + std::to_string(j), 1.0 / j);
+            }
+            adjoint.SetObjective("y^2", "y^2");
+            adjoint.SetCheckpointBudget(budget);
+
+            std::vector<double> gradient;
+            const auto start = std::chrono::steady_clock::now();
+            adjoint.Solve(1.0, h, tf, 0.0, expr, gradient);
+            const double seconds = SecondsSince(start);
+
+            const AdjointStats& stats = adjoint.GetAdjointStats();
+            std::cout << std::left << std::setw(10) << (budget == 0 ? std::string("all") : std::to_string(budget)) << std::right
+                << std::setw(13) << stats.checkpoints << std::setw(9) << stats.segmentLength << std::setw(13) << stats.peakStates
+                << std::setw(13) << stats.recomputedSteps << std::fixed << std::setprecision(4) << std::setw(10) << seconds
+                << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+        return 0;
+    }
+
+    // Logistic growth fitted to noisy samples written to a CSV file, from a
+    // poor first guess of the rate, the capacity and the initial value
+    int FitBenchmark()
+    {
+        const double rate = 0.8, capacity = 10, y0 = 0.5;
+        const char* expr = "r*y*(1 - y/K)";
+        const char* path = "fit_benchmark.csv";
+        const int samples = 40;
+        const double noise = 0.05;
+
+        // Samples of the exact solution with Gaussian noise
+        {
+            std::mt19937 random(2024);
+            std::normal_distribution<double> normal(0, noise);
+            std::ofstream file(path);
+            file << "t,y\n" << std::setprecision(17);
+            for (int i = 1; i <= samples; i++)
+            {
+                const double t = 10.0 * i / samples;
+                const double exact = capacity / (1 + (capacity / y0 - 1) * std::exp(-rate * t));
+                file << t << "," << exact + normal(random) << "\n";
+            }
+        }
+
+        std::cout << "y' = " << expr << " fitted to " << samples << " samples of r = " << rate << ", K = " << capacity
+            << ", y0 = " << y0 << " with noise " << noise << "\n\n";
+        std::cout << std::left << std::setw(8) << "h" << std::right << std::setw(8) << "r" << std::setw(9) << "K" << std::setw(9) << "y0"
+            << std::setw(12) << "RSS" << std::setw(12) << "iterations" << std::setw(8) << "solves" << std::setw(13) << "evaluations"
+            << std::setw(10) << "seconds" << "\n";
+
+        const double steps[] = { 0.1, 0.01 };
+        for (double h : steps)
+        {
+            ParameterFitter<double> fitter;
+            if (!fitter.LoadData(path))
+            {
+                std::cerr << "Could not read " << path << "\n";
+                return 1;
+            }
+            fitter.AddParameter("r", 0.3);
+            fitter.AddParameter("K", 5);
+            fitter.SetFitInitialValue(true);
+
+            const auto start = std::chrono::steady_clock::now();
+            const FitResult<double> result = fitter.Fit(1.0, h, 0.0, expr);
+            const double seconds = SecondsSince(start);
+
+            std::cout << std::left << std::setw(8) << h << std::right << std::fixed << std::setprecision(4)
+                << std::setw(8) << result.values[0] << std::setw(9) << result.values[1] << std::setw(9) << result.initialValue
+                << std::scientific << std::setprecision(3) << std::setw(12) << 2 * result.cost << std::setw(12) << result.iterations
+                << std::setw(8) << result.solves << std::setw(13) << fitter.GetStats().evaluations << std::fixed << std::setprecision(4)
+                << std::setw(10) << seconds << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+        std::cout << "\n(one solve gives the residuals and the whole Jacobian; finite differences would need 4 solves per Jacobian)\n";
+        std::remove(path);
+        return 0;
+    }
+
+    // Multiple shooting against hand-written secant iteration over Solve on a
+    // boundary problem whose solution is very sensitive to its initial value
+    int ShootingBenchmark()
+    {
+        const std::string expr = "8*(y - sin(t)) + cos(t)";
+        const double h = 1e-3, tf = 4, target = std::sin(tf), guess = 0.5;
+        const BoundaryCondition<double> condition = { 0.0, 1.0, target };
+
+        std::cout << "y' = " << expr << ", y(" << tf << ") = sin(" << tf << "), exact y(0) = 0, RK4 with h = " << h
+            << ", " << std::thread::hardware_concurrency() << " hardware threads\n\n";
+        std::cout << std::left << std::setw(24) << "method" << std::right << std::setw(12) << "iterations" << std::setw(8) << "shots"
+            << std::setw(13) << "evaluations" << std::setw(14) << "y(0) error" << std::setw(12) << "residual" << std::setw(10) << "seconds" << "\n";
+
+        auto report = [](const std::string& name, int iterations, long long shots, long long evaluations, double error, double residual, double seconds)
+        {
+            std::cout << std::left << std::setw(24) << name << std::right << std::setw(12) << iterations << std::setw(8) << shots
+                << std::setw(13) << evaluations << std::scientific << std::setprecision(2) << std::setw(14) << error << std::setw(12) << residual
+                << std::fixed << std::setprecision(4) << std::setw(10) << seconds << std::defaultfloat << std::setprecision(6) << "\n";
+        };
+
+        // Secant on y(t_f; y0) - target, one full Solve per iteration
+        {
+            RungeKuttaSolver<double> solver;
+            std::vector<std::vector<double>> out;
+            const auto start = std::chrono::steady_clock::now();
+            long long evaluations = 0;
+            auto shoot = [&](double y0)
+            {
+                solver.Solve(y0, h, tf, 0.0, expr, out);
+                evaluations += solver.GetStats().evaluations;
+                return out.back()[1] - target;
+            };
+            double a = guess, b = guess + 1e-3;
+            double fa = shoot(a), fb = shoot(b);
+            int iterations = 0;
+            while (iterations < 50 && std::fabs(fb) > 1e-10 && fb != fa)
+            {
+                const double next = b - fb * (b - a) / (fb - fa);
+                a = b;
+                fa = fb;
+                b = next;
+                fb = shoot(b);
+                iterations++;
+            }
+            report("serial secant", iterations, iterations + 2, evaluations, std::fabs(b), std::fabs(fb), SecondsSince(start));
+        }
+
+        const int segmentCounts[] = { 1, 2, 4, 8, 16 };
+        for (int segments : segmentCounts)
+        {
+            ShootingSolver<double> shooting;
+            shooting.SetSegments(segments);
+            std::vector<std::vector<double>> out;
+            const auto start = std::chrono::steady_clock::now();
+            try
+            {
+                shooting.Solve(guess, h, tf, 0.0, expr, condition, out);
+            }
+            catch (std::runtime_error& e)
+            {
+                std::cout << std::left << std::setw(24) << std::to_string(segments) + " segment(s)" << e.what() << "\n";
+                continue;
+            }
+            const double seconds = SecondsSince(start);
+            const ShootingStats<double>& stats = shooting.GetShootingStats();
+            report(std::to_string(segments) + (segments == 1 ? " segment" : " segments") + (stats.converged ? "" : " (no conv.)"),
+                stats.iterations, stats.shots, shooting.GetStats().evaluations, std::fabs(out[0][1]), stats.residual, seconds);
+        }
+        std::cout << "\n(the shots of one iteration run as a single parallel wave; errors in y(0) grow by e^(8 t_f / segments) along a shot)\n";
+        return 0;
+    }
+
+    // Cost of periodic checkpoints on a long fixed-step run, and a resume from
+    // the last one against the uninterrupted result
+    int CheckpointBenchmark()
+    {
+        const std::string expr = "-0.5*y + sin(t)";
+        const std::string path = "checkpoint_benchmark.cp";
+        const double h = 1e-4, tf = 100;
+
+        RungeKuttaSolver<double> reference;
+        std::vector<std::vector<double>> full;
+        auto start = std::chrono::steady_clock::now();
+        reference.Solve(1.0, h, tf, 0.0, expr, full);
+        const double baseSeconds = SecondsSince(start);
+
+        std::cout << "y' = " << expr << ", RK4 with h = " << h << " to t = " << tf << " (" << full.size() - 1 << " steps)\n\n";
+        std::cout << std::left << std::setw(12) << "interval" << std::right << std::setw(13) << "checkpoints" << std::setw(10)
+            << "seconds" << std::setw(10) << "overhead" << "\n";
+        std::cout << std::left << std::setw(12) << "none" << std::right << std::setw(13) << 0 << std::fixed << std::setprecision(4)
+            << std::setw(10) << baseSeconds << std::setw(10) << "" << std::defaultfloat << std::setprecision(6) << "\n";
+
+        const long long intervals[] = { 100000, 10000, 1000 };
+        for (long long interval : intervals)
+        {
+            RungeKuttaSolver<double> solver;
+            long long checkpoints = 0;
+            solver.SetCheckpoint(path, interval, [&](const std::vector<std::vector<double>>&, size_t, size_t) { checkpoints++; });
+            std::vector<std::vector<double>> out;
+            start = std::chrono::steady_clock::now();
+            solver.Solve(1.0, h, tf, 0.0, expr, out);
+            const double seconds = SecondsSince(start);
+
+            // The sink also runs once for the rows after the last checkpoint
+            std::cout << std::left << std::setw(12) << interval << std::right << std::setw(13) << checkpoints - 1 << std::fixed
+                << std::setprecision(4) << std::setw(10) << seconds << std::setprecision(1) << std::setw(9)
+                << 100 * (seconds / baseSeconds - 1) << "%" << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+
+        // Stop at the third checkpoint as a preempted job would, then resume
+        RungeKuttaSolver<double> interrupted;
+        std::vector<std::vector<double>> rows;
+        int calls = 0;
+        interrupted.SetCheckpoint(path, 250000, [&](const std::vector<std::vector<double>>& out, size_t begin, size_t end)
+            {
+                if (++calls == 3)
+                {
+                    throw std::runtime_error("preempted");
+                }
+                rows.insert(rows.end(), out.begin() + begin, out.begin() + end);
+            });
+        std::vector<std::vector<double>> out;
+        try
+        {
+            interrupted.Solve(1.0, h, tf, 0.0, expr, out);
+        }
+        catch (std::runtime_error&)
+        {
+        }
+
+        RungeKuttaSolver<double> resumed;
+        start = std::chrono::steady_clock::now();
+        resumed.Resume(path, out);
+        const double resumeSeconds = SecondsSince(start);
+        rows.insert(rows.end(), out.begin(), out.end());
+
+        double difference = rows.size() == full.size() ? 0 : std::numeric_limits<double>::infinity();
+        for (size_t row = 0; row < rows.size() && row < full.size(); row++)
+        {
+            difference = std::max(difference, std::fabs(rows[row][1] - full[row][1]));
+        }
+        std::cout << "\nResumed at row " << rows.size() - out.size() << " in " << std::fixed << std::setprecision(4) << resumeSeconds
+            << " s, max difference from the uninterrupted run " << std::scientific << std::setprecision(2) << difference
+            << std::defaultfloat << std::setprecision(6) << "\n";
+        std::remove(path.c_str());
+        return 0;
+    }
+
+    // Carrying a solution on to later final times against re-solving from t0
+    // for each new final time
+    int ExtendBenchmark()
+    {
+        const std::string expr = "-0.5*y + sin(t)";
+        const double h = 1e-4, first = 10, increment = 10;
+        const int extensions = 10;
+
+        std::cout << "y' = " << expr << ", RK4 with h = " << h << ", solved to t = " << first << " then extended "
+            << extensions << " times by " << increment << "\n\n";
+        std::cout << std::left << std::setw(12) << "approach" << std::right << std::setw(14) << "evaluations"
+            << std::setw(10) << "seconds" << std::setw(11) << "rows" << "\n";
+
+        RungeKuttaSolver<double> solver;
+        std::vector<std::vector<double>> out;
+        long long evaluations = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int extension = 0; extension <= extensions; extension++)
+        {
+            solver.Solve(1.0, h, first + extension * increment, 0.0, expr, out);
+            evaluations += solver.GetStats().evaluations;
+        }
+        const double resolveSeconds = SecondsSince(start);
+        std::cout << std::left << std::setw(12) << "re-solve" << std::right << std::setw(14) << evaluations << std::fixed
+            << std::setprecision(4) << std::setw(10) << resolveSeconds << std::setw(11) << out.size() << std::defaultfloat
+            << std::setprecision(6) << "\n";
+
+        OdeSolution<double> solution;
+        start = std::chrono::steady_clock::now();
+        solution.Solve(1.0, h, first, 0.0, expr);
+        for (int extension = 1; extension <= extensions; extension++)
+        {
+            solution.ExtendTo(first + extension * increment);
+        }
+        const double extendSeconds = SecondsSince(start);
+        const Trajectory<double>& trajectory = solution.GetTrajectory();
+        std::cout << std::left << std::setw(12) << "extend" << std::right << std::setw(14) << solution.GetStats().evaluations
+            << std::fixed << std::setprecision(4) << std::setw(10) << extendSeconds << std::setw(11) << trajectory.Size()
+            << std::defaultfloat << std::setprecision(6) << "\n";
+
+        // The extended trajectory should match the last full solve row for row
+        double difference = trajectory.Size() == out.size() ? 0 : std::numeric_limits<double>::infinity();
+        for (size_t row = 0; row < trajectory.Size() && row < out.size(); row++)
+        {
+            difference = std::max(difference, std::fabs(trajectory.Value(row) - out[row][1]) + std::fabs(trajectory.Time(row) - out[row][0]));
+        }
+        std::cout << "\nMax difference from a single solve to t = " << first + extensions * increment << ": " << std::scientific
+            << std::setprecision(2) << difference << std::defaultfloat << std::setprecision(6) << "\n";
+        return 0;
+    }
+
+    // Monitoring a long run through a sliding window against storing the whole
+    // trajectory and reducing it afterwards
+    int WindowBenchmark()
+    {
+        const std::string expr = "-0.5*y + sin(t)";
+        const double h = 1e-4;
+        const size_t windowRows = 1000;
+
+        std::cout << "y' = " << expr << ", RK4 with h = " << h << ", last " << windowRows << " rows kept\n\n";
+        std::cout << std::left << std::setw(8) << "t_f" << std::setw(10) << "mode" << std::right << std::setw(12) << "rows kept"
+            << std::setw(10) << "MB" << std::setw(10) << "seconds" << std::setw(12) << "mean" << std::setw(14) << "variance" << "\n";
+
+        // A stored row is a vector of two values plus its heap block
+        const double bytesPerRow = sizeof(std::vector<double>) + 2 * sizeof(double) + 16;
+
+        const double finalTimes[] = { 10, 100, 1000 };
+        for (double tf : finalTimes)
+        {
+            RungeKuttaSolver<double> solver;
+            std::vector<std::vector<double>> out;
+            auto start = std::chrono::steady_clock::now();
+            solver.Solve(1.0, h, tf, 0.0, expr, out);
+            double mean = 0, m2 = 0;
+            for (size_t row = 0; row < out.size(); row++)
+            {
+                const double delta = out[row][1] - mean;
+                mean += delta / double(row + 1);
+                m2 += delta * (out[row][1] - mean);
+            }
+            double seconds = SecondsSince(start);
+            std::cout << std::left << std::setw(8) << tf << std::setw(10) << "store" << std::right << std::setw(12) << out.size()
+                << std::fixed << std::setprecision(1) << std::setw(10) << out.size() * bytesPerRow / 1e6 << std::setprecision(4)
+                << std::setw(10) << seconds << std::scientific << std::setprecision(5) << std::setw(12) << mean << std::setw(14)
+                << m2 / double(out.size() - 1) << std::defaultfloat << std::setprecision(6) << "\n";
+            out = std::vector<std::vector<double>>();
+
+            // Batch and window are the only rows held
+            const size_t batchRows = 4096;
+            SlidingWindow<double> window(windowRows);
+            solver.SetStreaming(batchRows, window.Sink());
+            start = std::chrono::steady_clock::now();
+            solver.Solve(1.0, h, tf, 0.0, expr, out);
+            seconds = SecondsSince(start);
+            const WindowAggregates<double>& all = window.GetAggregates();
+            std::cout << std::left << std::setw(8) << tf << std::setw(10) << "window" << std::right << std::setw(12)
+                << batchRows + windowRows << std::fixed << std::setprecision(1) << std::setw(10)
+                << (batchRows * bytesPerRow + 2 * windowRows * sizeof(double)) / 1e6 << std::setprecision(4) << std::setw(10) << seconds
+                << std::scientific << std::setprecision(5) << std::setw(12) << all.mean << std::setw(14) << all.Variance()
+                << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+        return 0;
+    }
+
+    // Summary-only runs against storing the trajectory, and writing rows with
+    // std::endl against '\n'
+    int SummaryBenchmark()
+    {
+        const std::string expr = "-0.5*y + sin(t)";
+        const char* path = "summary_benchmark.txt";
+        const double h = 1e-4, tf = 100;
+
+        std::cout << "y' = " << expr << ", RK4 with h = " << h << " to t = " << tf << ", all reductions\n\n";
+        std::cout << std::left << std::setw(26) << "mode" << std::right << std::setw(10) << "seconds" << std::setw(14) << "integral"
+            << std::setw(11) << "crossings" << "\n";
+        auto report = [](const std::string& mode, double seconds, double integral, long long crossings)
+        {
+            std::cout << std::left << std::setw(26) << mode << std::right << std::fixed << std::setprecision(4) << std::setw(10) << seconds
+                << std::setprecision(6) << std::setw(14) << integral << std::setw(11) << crossings << std::defaultfloat << std::setprecision(6) << "\n";
+        };
+
+        RungeKuttaSolver<double> solver;
+        std::vector<std::vector<double>> out;
+        auto start = std::chrono::steady_clock::now();
+        solver.Solve(1.0, h, tf, 0.0, expr, out);
+        TrajectorySummary<double> stored;
+        for (const std::vector<double>& row : out)
+        {
+            stored.Add(row[0], row[1]);
+        }
+        report("solve, then reduce", SecondsSince(start), stored.GetValues().integral, stored.GetValues().crossings);
+
+        TrajectorySummary<double> summary;
+        solver.SetStreaming(256, summary.Sink());
+        start = std::chrono::steady_clock::now();
+        solver.Solve(1.0, h, tf, 0.0, expr, out);
+        report("summary only", SecondsSince(start), summary.GetValues().integral, summary.GetValues().crossings);
+
+        // The interactive session's row display, to a file so the terminal does not dominate
+        for (int flushEachRow = 1; flushEachRow >= 0; flushEachRow--)
+        {
+            RungeKuttaSolver<double> printer;
+            printer.Solve(1.0, h, tf, 0.0, expr, out);
+            std::ofstream file(path);
+            start = std::chrono::steady_clock::now();
+            for (const std::vector<double>& row : out)
+            {
+                file << "t: " << row[0] << "  y: " << row[1];
+                if (flushEachRow)
+                {
+                    file << std::endl;
+                }
+                else
+                {
+                    file << '\n';
+                }
+            }
+            file.flush();
+            std::cout << std::left << std::setw(26) << (flushEachRow ? "print rows, std::endl" : "print rows, '\\n'") << std::right
+                << std::fixed << std::setprecision(4) << std::setw(10) << SecondsSince(start) << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+        std::remove(path);
+        return 0;
+    }
+
+    // Bulirsch-Stoer started with a first step far too large, so the first
+    // attempt is rejected after only one extrapolated column. Fails if the
+    // retry does not recover the solution.
+    int ExtrapolationRejectBenchmark()
+    {
+        struct Case
+        {
+            const char* expr;
+            double tf;
+            double h0;
+            double tolerance;
+            double exact;
+        };
+        const Case cases[] =
+        {
+            { "-1000*y", 1, 1, 1e-2, std::exp(-1000.0) },
+            { "-1000*y", 1, 1, 1e-6, std::exp(-1000.0) },
+            { "y*y", 0.9, 0.9, 1e-6, 10 },
+        };
+
+        std::cout << std::left << std::setw(10) << "f(t, y)" << std::right << std::setw(8) << "h0" << std::setw(12) << "tolerance"
+            << std::setw(8) << "steps" << std::setw(10) << "rejected" << std::setw(12) << "|error|" << "\n";
+
+        bool passed = true;
+        for (const Case& c : cases)
+        {
+            BulirschStoerSolver<double> gbs;
+            gbs.SetTolerances(c.tolerance, c.tolerance);
+            std::vector<std::vector<double>> out;
+            gbs.Solve(1.0, c.h0, c.tf, 0.0, c.expr, out);
+
+            const double error = std::fabs(out.back()[1] - c.exact);
+            const SolverStats& stats = gbs.GetStats();
+            const bool ok = std::isfinite(error) && error <= 100 * c.tolerance * (1 + std::fabs(c.exact)) && stats.rejectedSteps > 0;
+            passed = passed && ok;
+
+            std::cout << std::left << std::setw(10) << c.expr << std::right << std::setw(8) << c.h0 << std::scientific
+                << std::setprecision(0) << std::setw(12) << c.tolerance << std::setw(8) << stats.steps << std::setw(10)
+                << stats.rejectedSteps << std::setprecision(2) << std::setw(12) << error << std::defaultfloat << std::setprecision(6)
+                << (ok ? "" : "  FAILED") << "\n";
+        }
+        return passed ? 0 : 1;
+    }
+
+    const Benchmark Benchmarks[] =
+    {
+        { "precision", "RK4 steps needed for a target error in float, double and long double", PrecisionBenchmark },
+        { "mixed", "float evaluation with double or Kahan-compensated state versus pure float and double", MixedPrecisionBenchmark },
+        { "methods", "RHS evaluations each Runge-Kutta tableau and Bulirsch-Stoer need for a target error", MethodsBenchmark },
+        { "stiff", "steps and evaluations of explicit and implicit solvers on stiff decay problems", StiffBenchmark },
+        { "switching", "automatic explicit/implicit switching on a problem with stiff and non-stiff phases", SwitchingBenchmark },
+        { "multistep", "RHS evaluations saved by Adams-Bashforth-Moulton over RK4", MultistepBenchmark },
+        { "taylor", "adaptive-order Taylor series from automatic differentiation versus RK4", TaylorBenchmark },
+        { "dense", "output on a fine grid by dense output from large steps versus stepping at the output spacing", DenseBenchmark },
+        { "events", "integration stopped at a terminal event versus run to the final time", EventsBenchmark },
+        { "steady", "integration stopped once the solution settles versus run to the final time", SteadyStateBenchmark },
+        { "parareal", "parallel-in-time Parareal versus serial RK4 on a long trajectory", PararealBenchmark },
+        { "ensemble", "work-stealing versus static scheduling of an ensemble with skewed member costs", EnsembleBenchmark },
+        { "simd", "ensemble throughput per core of lane-batched RK4 at each SIMD level versus exprtk", SimdBenchmark },
+        { "sweep", "parameter sweep with a named parameter updated in place versus recompiling the edited expression", SweepBenchmark },
+        { "grid", "parallel parameter grid streamed to a columnar file versus separate Solve calls", GridBenchmark },
+        { "sensitivity", "forward sensitivities in one pass versus central differences of repeated solves", SensitivityBenchmark },
+        { "adjoint", "adjoint gradients versus forward sensitivities as parameters grow, and checkpoint budgets", AdjointBenchmark },
+        { "fit", "Levenberg-Marquardt fit of parameters and y0 to CSV data using forward sensitivities", FitBenchmark },
+        { "shooting", "multiple shooting for a boundary value problem versus serial secant iteration over Solve", ShootingBenchmark },
+        { "checkpoint", "overhead of periodic checkpoints on a long run, and resuming from one", CheckpointBenchmark },
+        { "extend", "extending a solution to later final times versus re-solving from t0", ExtendBenchmark },
+        { "window", "sliding window with running aggregates versus storing and reducing the whole trajectory", WindowBenchmark },
+        { "summary", "summary-only reductions versus storing the trajectory, and row output with std::endl versus newlines", SummaryBenchmark },
+        { "gbs-reject", "Bulirsch-Stoer recovering from a rejected oversized first step", ExtrapolationRejectBenchmark },
+    };
+}
+
+int RunBenchmark(const std::string& name)
+{
+    for (const Benchmark& benchmark : Benchmarks)
+    {
+        if (name == benchmark.name)
+        {
+            return benchmark.run();
+        }
+    }
+
+    std::cerr << "Unknown benchmark: " << name << "\nAvailable benchmarks:\n";
+    for (const Benchmark& benchmark : Benchmarks)
+    {
+        std::cerr << "  " << benchmark.name << "  " << benchmark.description << "\n";
+    }
+    return 1;
+}
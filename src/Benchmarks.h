@@ -0,0 +1,6 @@
+#pragma once
+#include <string>
+
+// Runs the named benchmark and prints its report to stdout. Returns the process
+// exit code; unknown names list the available benchmarks.
+int RunBenchmark(const std::string& name);
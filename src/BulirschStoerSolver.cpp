@@ -0,0 +1,193 @@
+#include "BulirschStoerSolver.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+template <typename T>
+BulirschStoerSolver<T>::BulirschStoerSolver()
+{
+}
+
+template <typename T>
+bool BulirschStoerSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str);
+}
+
+template <typename T>
+void BulirschStoerSolver<T>::SetTolerances(const T& relative, const T& absolute)
+{
+    relativeTolerance = relative;
+    absoluteTolerance = absolute;
+}
+
+template <typename T>
+const SolverStats& BulirschStoerSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+// n - 1 leapfrog steps after an Euler start, then Gragg's smoothing step. The
+// error expands in even powers of h / n, which is what makes the h^2
+// extrapolation work. Costs n evaluations on top of f0.
+template <typename T>
+T BulirschStoerSolver<T>::ModifiedMidpoint(const T& t, const T& y, const T& h, const T& f0, int n)
+{
+    const T sub = h / n;
+    T previous = y;
+    T current = y + sub * f0;
+    for (int m = 1; m < n; m++)
+    {
+        const T next = previous + 2 * sub * dydt(t + m * sub, current);
+        previous = current;
+        current = next;
+    }
+    return (previous + current + sub * dydt(t + h, current)) / 2;
+}
+
+template <typename T>
+void BulirschStoerSolver<T>::Solve(const T& y0, const T& h0, const T& t, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    if (!expression.Compile(expr))
+    {
+        throw std::runtime_error("Invalid expression: " + expr);
+    }
+    stats = SolverStats();
+
+    TraceSpan solveSpan("solve");
+
+    const T minStep = 16 * std::numeric_limits<T>::epsilon();
+
+    // Evaluations needed to build the table up to each column
+    T cost[MaxColumns];
+    cost[0] = T(1 + Substeps(0));
+    for (int k = 1; k < MaxColumns; k++)
+    {
+        cost[k] = cost[k - 1] + Substeps(k);
+    }
+
+    // Starting column from the tolerance, as in ODEX; the step may try one past it
+    int target = int(-std::log10(double(relativeTolerance)) * 0.6 + 1.5);
+    target = std::max(2, std::min(MaxColumns - 2, target));
+
+    T w = y0;
+    T i = t0;
+    T h = std::min(h0, t - t0);
+    T f0 = dydt(i, w);
+    bool rejected = false;
+
+    T optimalStep[MaxColumns];
+    T work[MaxColumns];
+
+    out.clear();
+    out.push_back({ i, w });
+
+    while (i < t)
+    {
+        if (h <= minStep * std::max(T(1), std::fabs(i)))
+        {
+            throw std::runtime_error("Step size underflow in Bulirsch-Stoer integration");
+        }
+
+        const T last = i + h >= t ? t : i + h;
+        const T step = last - i;
+
+        int column = 0;
+        bool accepted = false;
+        for (int k = 0; k <= target + 1; k++)
+        {
+            // Next line of the table, extrapolated with Aitken-Neville
+            table[k][0] = ModifiedMidpoint(i, w, step, f0, Substeps(k));
+            for (int j = 1; j <= k; j++)
+            {
+                const T ratio = T(Substeps(k)) / T(Substeps(k - j));
+                table[k][j] = table[k][j - 1] + (table[k][j - 1] - table[k - 1][j - 1]) / (ratio * ratio - 1);
+            }
+            if (k == 0)
+            {
+                continue;
+            }
+
+            const T scale = absoluteTolerance + relativeTolerance * std::max(std::fabs(w), std::fabs(table[k][k]));
+            const T error = std::fabs(table[k][k] - table[k][k - 1]) / scale;
+            const T exponent = T(1) / (2 * k + 1);
+            const T factor = error == 0 ? T(4) : std::min(T(4), std::max(T(0.02), T(0.94) * std::pow(T(0.65) / error, exponent)));
+            optimalStep[k] = step * factor;
+            work[k] = cost[k] / optimalStep[k];
+            column = k;
+
+            if (k < target - 1)
+            {
+                continue;
+            }
+            if (error <= 1)
+            {
+                accepted = true;
+                break;
+            }
+
+            // Stop early when the remaining lines cannot be expected to bring
+            // the error below one, since each reduces it by about (n_k / n_0)^2
+            const T first = T(Substeps(0));
+            const T reachable = k == target - 1
+                ? T(Substeps(target + 1)) * T(Substeps(target)) / (first * first)
+                : T(Substeps(target + 1)) / first;
+            if (k < target + 1 && error > reachable * reachable)
+            {
+                break;
+            }
+        }
+
+        if (!accepted)
+        {
+            stats.rejectedSteps++;
+            rejected = true;
+            // Only the columns built in this attempt have a step estimate, and
+            // the first step may stop after column 1
+            int built = std::min(target, column);
+            if (built > 2 && work[built - 1] < T(0.9) * work[built])
+            {
+                built--;
+            }
+            target = std::max(2, built);
+            h = std::min(step, optimalStep[built]);
+            continue;
+        }
+
+        i = last;
+        w = table[column][column];
+        f0 = dydt(i, w);
+        out.push_back({ i, w });
+        stats.steps++;
+
+        // Next order: the neighbouring column if it does less work per unit step
+        int next = column;
+        if (column >= 3 && work[column - 1] < T(0.8) * work[column])
+        {
+            next = column - 1;
+        }
+        else if (column >= 2 && column < MaxColumns - 2 && !rejected && work[column] < T(0.9) * work[column - 1])
+        {
+            next = column + 1;
+        }
+
+        target = std::max(2, next);
+        h = next > column ? optimalStep[column] * cost[next] / cost[column] : optimalStep[std::max(1, next)];
+        if (rejected)
+        {
+            h = std::min(h, step);
+        }
+        rejected = false;
+    }
+}
+
+template class BulirschStoerSolver<float>;
+template class BulirschStoerSolver<double>;
+template class BulirschStoerSolver<long double>;
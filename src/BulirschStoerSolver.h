@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "OdeExpression.h"
+#include "SolverStats.h"
+
+// Gragg-Bulirsch-Stoer extrapolation for smooth problems at tight tolerances.
+// Each macro step runs Gragg's modified midpoint rule with n = 2, 4, 6, ...
+// substeps and extrapolates the results to n -> infinity with Aitken-Neville
+// in h^2, so column k of the table has order 2k + 2. Order and step size are
+// chosen together, as in Hairer and Wanner's ODEX, by minimising the work per
+// unit step: the evaluations spent on a column over the step it allows.
+template <typename T>
+class BulirschStoerSolver
+{
+public:
+
+    BulirschStoerSolver();
+
+    // h is the initial step; the output holds every accepted step
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    void SetTolerances(const T& relative, const T& absolute);
+
+    const SolverStats& GetStats() const;
+
+private:
+
+    static const int MaxColumns = 9;
+
+    static int Substeps(int column)
+    {
+        return 2 * (column + 1);
+    }
+
+    // Gragg's modified midpoint rule over h with n substeps, given f0 = f(t, y)
+    T ModifiedMidpoint(const T& t, const T& y, const T& h, const T& f0, int n);
+
+    T dydt(const T& t, const T& y)
+    {
+        stats.evaluations++;
+        return expression.Evaluate(t, y);
+    }
+
+    OdeExpression<T> expression;
+    T relativeTolerance = T(1e-6);
+    T absoluteTolerance = T(1e-6);
+    SolverStats stats;
+
+    // Extrapolation table, row j holds the line computed from Substeps(j)
+    T table[MaxColumns][MaxColumns];
+};
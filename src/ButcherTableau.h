@@ -0,0 +1,216 @@
+#pragma once
+#include <string>
+
+// Compile-time Butcher tableaux for the explicit Runge-Kutta methods. The
+// coefficients are long double so every instantiation gets them correctly rounded.
+// Every tableau provides Stages, Order, C, A (strictly lower triangular) and B,
+// and marks whether its last stage is f(t + h, y_n+1) so it can be reused as
+// the first stage of the next step. Embedded pairs also provide EmbeddedOrder
+// and E = B - BHat, the weights of the local error estimate.
+
+struct EulerTableau
+{
+    static constexpr const char* Name = "euler";
+    static constexpr int Stages = 1;
+    static constexpr int Order = 1;
+    static constexpr bool Embedded = false;
+    static constexpr bool FirstSameAsLast = false;
+    static constexpr long double C[Stages] = { 0 };
+    static constexpr long double A[Stages][Stages] = { { 0 } };
+    static constexpr long double B[Stages] = { 1 };
+};
+
+struct HeunTableau
+{
+    static constexpr const char* Name = "heun";
+    static constexpr int Stages = 2;
+    static constexpr int Order = 2;
+    static constexpr bool Embedded = false;
+    static constexpr bool FirstSameAsLast = false;
+    static constexpr long double C[Stages] = { 0, 1 };
+    static constexpr long double A[Stages][Stages] =
+    {
+        { 0, 0 },
+        { 1, 0 },
+    };
+    static constexpr long double B[Stages] = { 1.0L / 2, 1.0L / 2 };
+};
+
+struct Rk3Tableau
+{
+    static constexpr const char* Name = "rk3";
+    static constexpr int Stages = 3;
+    static constexpr int Order = 3;
+    static constexpr bool Embedded = false;
+    static constexpr bool FirstSameAsLast = false;
+    static constexpr long double C[Stages] = { 0, 1.0L / 2, 1 };
+    static constexpr long double A[Stages][Stages] =
+    {
+        { 0, 0, 0 },
+        { 1.0L / 2, 0, 0 },
+        { -1, 2, 0 },
+    };
+    static constexpr long double B[Stages] = { 1.0L / 6, 2.0L / 3, 1.0L / 6 };
+};
+
+struct Rk4Tableau
+{
+    static constexpr const char* Name = "rk4";
+    static constexpr int Stages = 4;
+    static constexpr int Order = 4;
+    static constexpr bool Embedded = false;
+    static constexpr bool FirstSameAsLast = false;
+    static constexpr long double C[Stages] = { 0, 1.0L / 2, 1.0L / 2, 1 };
+    static constexpr long double A[Stages][Stages] =
+    {
+        { 0, 0, 0, 0 },
+        { 1.0L / 2, 0, 0, 0 },
+        { 0, 1.0L / 2, 0, 0 },
+        { 0, 0, 1, 0 },
+    };
+    static constexpr long double B[Stages] = { 1.0L / 6, 1.0L / 3, 1.0L / 3, 1.0L / 6 };
+};
+
+struct ThreeEighthsTableau
+{
+    static constexpr const char* Name = "rk38";
+    static constexpr int Stages = 4;
+    static constexpr int Order = 4;
+    static constexpr bool Embedded = false;
+    static constexpr bool FirstSameAsLast = false;
+    static constexpr long double C[Stages] = { 0, 1.0L / 3, 2.0L / 3, 1 };
+    static constexpr long double A[Stages][Stages] =
+    {
+        { 0, 0, 0, 0 },
+        { 1.0L / 3, 0, 0, 0 },
+        { -1.0L / 3, 1, 0, 0 },
+        { 1, -1, 1, 0 },
+    };
+    static constexpr long double B[Stages] = { 1.0L / 8, 3.0L / 8, 3.0L / 8, 1.0L / 8 };
+};
+
+// Butcher's six stage fifth order method
+struct Rk5Tableau
+{
+    static constexpr const char* Name = "rk5";
+    static constexpr int Stages = 6;
+    static constexpr int Order = 5;
+    static constexpr bool Embedded = false;
+    static constexpr bool FirstSameAsLast = false;
+    static constexpr long double C[Stages] = { 0, 1.0L / 4, 1.0L / 4, 1.0L / 2, 3.0L / 4, 1 };
+    static constexpr long double A[Stages][Stages] =
+    {
+        { 0, 0, 0, 0, 0, 0 },
+        { 1.0L / 4, 0, 0, 0, 0, 0 },
+        { 1.0L / 8, 1.0L / 8, 0, 0, 0, 0 },
+        { 0, -1.0L / 2, 1, 0, 0, 0 },
+        { 3.0L / 16, 0, 0, 9.0L / 16, 0, 0 },
+        { -3.0L / 7, 2.0L / 7, 12.0L / 7, -12.0L / 7, 8.0L / 7, 0 },
+    };
+    static constexpr long double B[Stages] = { 7.0L / 90, 0, 32.0L / 90, 12.0L / 90, 32.0L / 90, 7.0L / 90 };
+};
+
+// Bogacki-Shampine 3(2) pair
+struct BogackiShampineTableau
+{
+    static constexpr const char* Name = "bs32";
+    static constexpr int Stages = 4;
+    static constexpr int Order = 3;
+    static constexpr bool Embedded = true;
+    static constexpr int EmbeddedOrder = 2;
+    static constexpr bool FirstSameAsLast = true;
+    static constexpr long double C[Stages] = { 0, 1.0L / 2, 3.0L / 4, 1 };
+    static constexpr long double A[Stages][Stages] =
+    {
+        { 0, 0, 0, 0 },
+        { 1.0L / 2, 0, 0, 0 },
+        { 0, 3.0L / 4, 0, 0 },
+        { 2.0L / 9, 1.0L / 3, 4.0L / 9, 0 },
+    };
+    static constexpr long double B[Stages] = { 2.0L / 9, 1.0L / 3, 4.0L / 9, 0 };
+    static constexpr long double E[Stages] =
+    {
+        2.0L / 9 - 7.0L / 24, 1.0L / 3 - 1.0L / 4, 4.0L / 9 - 1.0L / 3, -1.0L / 8
+    };
+};
+
+// Dormand-Prince 5(4) pair
+struct DormandPrinceTableau
+{
+    static constexpr const char* Name = "dopri5";
+    static constexpr int Stages = 7;
+    static constexpr int Order = 5;
+    static constexpr bool Embedded = true;
+    static constexpr int EmbeddedOrder = 4;
+    static constexpr bool FirstSameAsLast = true;
+    static constexpr long double C[Stages] = { 0, 1.0L / 5, 3.0L / 10, 4.0L / 5, 8.0L / 9, 1, 1 };
+    static constexpr long double A[Stages][Stages] =
+    {
+        { 0, 0, 0, 0, 0, 0, 0 },
+        { 1.0L / 5, 0, 0, 0, 0, 0, 0 },
+        { 3.0L / 40, 9.0L / 40, 0, 0, 0, 0, 0 },
+        { 44.0L / 45, -56.0L / 15, 32.0L / 9, 0, 0, 0, 0 },
+        { 19372.0L / 6561, -25360.0L / 2187, 64448.0L / 6561, -212.0L / 729, 0, 0, 0 },
+        { 9017.0L / 3168, -355.0L / 33, 46732.0L / 5247, 49.0L / 176, -5103.0L / 18656, 0, 0 },
+        { 35.0L / 384, 0, 500.0L / 1113, 125.0L / 192, -2187.0L / 6784, 11.0L / 84, 0 },
+    };
+    static constexpr long double B[Stages] = { 35.0L / 384, 0, 500.0L / 1113, 125.0L / 192, -2187.0L / 6784, 11.0L / 84, 0 };
+    static constexpr long double E[Stages] =
+    {
+        35.0L / 384 - 5179.0L / 57600, 0, 500.0L / 1113 - 7571.0L / 16695, 125.0L / 192 - 393.0L / 640,
+        -2187.0L / 6784 + 92097.0L / 339200, 11.0L / 84 - 187.0L / 2100, -1.0L / 40
+    };
+};
+
+enum class Method
+{
+    Euler,
+    Heun,
+    Rk3,
+    Rk4,
+    ThreeEighths,
+    Rk5,
+    BogackiShampine,
+    DormandPrince,
+};
+
+// Calls visitor with a default-constructed tableau of the selected method, so
+// the integration loop is instantiated once per tableau and dispatched once per
+// solve rather than once per step.
+template <typename Visitor>
+void VisitTableau(Method method, Visitor&& visitor)
+{
+    switch (method)
+    {
+    case Method::Euler: visitor(EulerTableau()); break;
+    case Method::Heun: visitor(HeunTableau()); break;
+    case Method::Rk3: visitor(Rk3Tableau()); break;
+    case Method::Rk4: visitor(Rk4Tableau()); break;
+    case Method::ThreeEighths: visitor(ThreeEighthsTableau()); break;
+    case Method::Rk5: visitor(Rk5Tableau()); break;
+    case Method::BogackiShampine: visitor(BogackiShampineTableau()); break;
+    case Method::DormandPrince: visitor(DormandPrinceTableau()); break;
+    }
+}
+
+// Looks a method up by its tableau name (e.g. "rk4", "dopri5")
+inline bool ParseMethod(const std::string& name, Method& method)
+{
+    const Method methods[] =
+    {
+        Method::Euler, Method::Heun, Method::Rk3, Method::Rk4,
+        Method::ThreeEighths, Method::Rk5, Method::BogackiShampine, Method::DormandPrince,
+    };
+
+    for (Method candidate : methods)
+    {
+        bool matches = false;
+        VisitTableau(candidate, [&](auto tableau) { matches = name == decltype(tableau)::Name; });
+        if (matches)
+        {
+            method = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,165 @@
+#include "Checkpoint.h"
+#include "Tracer.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    const char Magic[4] = { 'R', 'K', 'C', 'P' };
+    const uint32_t Version = 2;
+
+    template <typename Value>
+    void Write(std::ofstream& file, const Value& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(Value));
+    }
+
+    template <typename Value>
+    bool Read(std::ifstream& file, Value& value)
+    {
+        return bool(file.read(reinterpret_cast<char*>(&value), sizeof(Value)));
+    }
+
+    void Write(std::ofstream& file, const SolverStats& stats)
+    {
+        Write(file, int64_t(stats.steps));
+        Write(file, int64_t(stats.rejectedSteps));
+        Write(file, int64_t(stats.evaluations));
+        Write(file, int64_t(stats.jacobianEvaluations));
+        Write(file, int64_t(stats.factorizations));
+    }
+
+    void Write(std::ofstream& file, const std::string& text)
+    {
+        Write(file, uint32_t(text.size()));
+        file.write(text.data(), std::streamsize(text.size()));
+    }
+
+    bool Read(std::ifstream& file, std::string& text)
+    {
+        uint32_t length = 0;
+        if (!Read(file, length))
+        {
+            return false;
+        }
+        text.resize(length);
+        return length == 0 || bool(file.read(&text[0], length));
+    }
+
+    bool Read(std::ifstream& file, SolverStats& stats)
+    {
+        int64_t steps, rejectedSteps, evaluations, jacobianEvaluations, factorizations;
+        if (!Read(file, steps) || !Read(file, rejectedSteps) || !Read(file, evaluations)
+            || !Read(file, jacobianEvaluations) || !Read(file, factorizations))
+        {
+            return false;
+        }
+        stats = { steps, rejectedSteps, evaluations, jacobianEvaluations, factorizations };
+        return true;
+    }
+}
+
+template <typename T>
+void SaveCheckpoint(const std::string& path, const SolverCheckpoint<T>& checkpoint)
+{
+    TraceSpan span("checkpoint");
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Could not create " + temporary);
+        }
+
+        file.write(Magic, sizeof(Magic));
+        Write(file, Version);
+        Write(file, uint32_t(sizeof(T)));
+        Write(file, checkpoint.expression);
+        Write(file, uint32_t(checkpoint.parameters.size()));
+        for (const std::pair<std::string, T>& parameter : checkpoint.parameters)
+        {
+            Write(file, parameter.first);
+            Write(file, parameter.second);
+        }
+        Write(file, int32_t(checkpoint.method));
+        Write(file, checkpoint.tolerance);
+        Write(file, checkpoint.t0);
+        Write(file, checkpoint.t);
+        Write(file, checkpoint.h);
+        Write(file, int64_t(checkpoint.index));
+        Write(file, checkpoint.time);
+        Write(file, checkpoint.y);
+        Write(file, checkpoint.step);
+        Write(file, checkpoint.slope);
+        Write(file, int64_t(checkpoint.rows));
+        Write(file, checkpoint.stats);
+
+        file.flush();
+        if (!file)
+        {
+            throw std::runtime_error("Could not write checkpoint " + temporary);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        throw std::runtime_error("Could not replace checkpoint " + path + ": " + error.message());
+    }
+}
+
+template <typename T>
+bool LoadCheckpoint(const std::string& path, SolverCheckpoint<T>& checkpoint)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(Magic)];
+    uint32_t version = 0, scalarSize = 0, parameters = 0;
+    SolverCheckpoint<T> loaded;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+        || !Read(file, version) || version != Version || !Read(file, scalarSize) || scalarSize != sizeof(T)
+        || !Read(file, loaded.expression) || !Read(file, parameters))
+    {
+        return false;
+    }
+
+    for (uint32_t p = 0; p < parameters; p++)
+    {
+        std::pair<std::string, T> parameter;
+        if (!Read(file, parameter.first) || !Read(file, parameter.second))
+        {
+            return false;
+        }
+        loaded.parameters.push_back(parameter);
+    }
+
+    int32_t method = 0;
+    int64_t index = 0, rows = 0;
+    if (!Read(file, method) || !Read(file, loaded.tolerance)
+        || !Read(file, loaded.t0) || !Read(file, loaded.t) || !Read(file, loaded.h) || !Read(file, index)
+        || !Read(file, loaded.time) || !Read(file, loaded.y) || !Read(file, loaded.step) || !Read(file, loaded.slope)
+        || !Read(file, rows) || !Read(file, loaded.stats))
+    {
+        return false;
+    }
+    if (method < int32_t(Method::Euler) || method > int32_t(Method::DormandPrince))
+    {
+        return false;
+    }
+
+    loaded.method = Method(method);
+    loaded.index = index;
+    loaded.rows = rows;
+    checkpoint = loaded;
+    return true;
+}
+
+template void SaveCheckpoint<float>(const std::string&, const SolverCheckpoint<float>&);
+template void SaveCheckpoint<double>(const std::string&, const SolverCheckpoint<double>&);
+template void SaveCheckpoint<long double>(const std::string&, const SolverCheckpoint<long double>&);
+template bool LoadCheckpoint<float>(const std::string&, SolverCheckpoint<float>&);
+template bool LoadCheckpoint<double>(const std::string&, SolverCheckpoint<double>&);
+template bool LoadCheckpoint<long double>(const std::string&, SolverCheckpoint<long double>&);
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+#include "ButcherTableau.h"
+#include "SolverStats.h"
+
+// Everything RungeKuttaSolver needs to continue a Solve part way through: the
+// problem, the position after the last saved step, the next step size for
+// adaptive runs, the slope carried into the next step by tableaus that reuse
+// their last stage, and the work counters so far. Parameters, events and the
+// steady state monitor are configuration rather than state and are set again
+// by whoever resumes; events and the monitor restart from the saved point.
+// The parameter values are saved too, so a resume with other values is
+// caught rather than continuing a different ODE.
+template <typename T>
+struct SolverCheckpoint
+{
+    std::string expression;
+    std::vector<std::pair<std::string, T>> parameters;
+    Method method = Method::Rk4;
+    T tolerance = T(0);
+    T t0 = T(0);
+    T t = T(0);
+    T h = T(0);
+
+    // Accepted steps so far and the state after them
+    long long index = 0;
+    T time = T(0);
+    T y = T(0);
+    T step = T(0);
+    T slope = T(0);
+
+    // Output rows already handed out, the one at (time, y) included
+    long long rows = 0;
+    SolverStats stats;
+};
+
+// Binary layout: "RKCP", version, sizeof(T), then the fields in order, with
+// strings as uint32 length and bytes and the parameters as a uint32 count
+// followed by each name and value. The file is written beside path and
+// renamed over it, so a crash while saving leaves the previous checkpoint
+// intact. Throws std::runtime_error on failure.
+template <typename T>
+void SaveCheckpoint(const std::string& path, const SolverCheckpoint<T>& checkpoint);
+
+// Returns false if the file is missing, truncated, from another version or
+// saved with a different scalar type
+template <typename T>
+bool LoadCheckpoint(const std::string& path, SolverCheckpoint<T>& checkpoint);
@@ -0,0 +1,112 @@
+#include "ColumnarFile.h"
+#include "Tracer.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const char Magic[4] = { 'R', 'K', 'C', 'F' };
+    const uint32_t Version = 1;
+
+    template <typename Value>
+    void Write(std::ofstream& file, const Value& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(Value));
+    }
+
+    template <typename Value>
+    bool Read(std::ifstream& file, Value& value)
+    {
+        return bool(file.read(reinterpret_cast<char*>(&value), sizeof(Value)));
+    }
+}
+
+ColumnarWriter::ColumnarWriter(const std::string& path, const std::vector<std::string>& columns)
+    : file(path, std::ios::binary | std::ios::trunc), columnCount(columns.size())
+{
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Could not create " + path);
+    }
+
+    file.write(Magic, sizeof(Magic));
+    Write(file, Version);
+    Write(file, uint32_t(columns.size()));
+    for (const std::string& name : columns)
+    {
+        Write(file, uint32_t(name.size()));
+        file.write(name.data(), name.size());
+    }
+}
+
+void ColumnarWriter::WriteGroup(const std::vector<std::vector<double>>& columns, size_t rows)
+{
+    if (rows == 0)
+    {
+        return;
+    }
+    if (columns.size() != columnCount)
+    {
+        throw std::runtime_error("Column count does not match the file header");
+    }
+
+    TraceSpan span("write");
+    Write(file, uint64_t(rows));
+    for (const std::vector<double>& column : columns)
+    {
+        file.write(reinterpret_cast<const char*>(column.data()), std::streamsize(rows * sizeof(double)));
+    }
+    if (!file)
+    {
+        throw std::runtime_error("Could not write row group");
+    }
+    rowCount += rows;
+}
+
+long long ColumnarWriter::GetRowCount() const
+{
+    return rowCount;
+}
+
+bool ReadColumnarFile(const std::string& path, std::vector<std::string>& names, std::vector<std::vector<double>>& columns)
+{
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(Magic)];
+    uint32_t version = 0, count = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+        || !Read(file, version) || version != Version || !Read(file, count))
+    {
+        return false;
+    }
+
+    names.assign(count, std::string());
+    columns.assign(count, std::vector<double>());
+    for (std::string& name : names)
+    {
+        uint32_t length = 0;
+        if (!Read(file, length))
+        {
+            return false;
+        }
+        name.resize(length);
+        if (!file.read(&name[0], length))
+        {
+            return false;
+        }
+    }
+
+    uint64_t rows = 0;
+    while (Read(file, rows))
+    {
+        for (std::vector<double>& column : columns)
+        {
+            const size_t start = column.size();
+            column.resize(start + rows);
+            if (!file.read(reinterpret_cast<char*>(column.data() + start), std::streamsize(rows * sizeof(double))))
+            {
+                return false;
+            }
+        }
+    }
+    return file.eof();
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary table written in row groups with each column stored contiguously
+// inside a group, so a reader can pull one column without parsing the rest
+// and a writer only ever holds one group in memory. Layout:
+//   "RKCF", uint32 version, uint32 column count,
+//   per column: uint32 name length, name bytes,
+//   per group: uint64 row count, then for each column row count doubles.
+// Integers and values are in the writer's native byte order so columns go
+// out in one write; files only move between machines of the same order.
+// Values are always stored as double whatever precision produced them.
+class ColumnarWriter
+{
+public:
+
+    // Throws std::runtime_error if the file cannot be created
+    ColumnarWriter(const std::string& path, const std::vector<std::string>& columns);
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    // Appends a group; columns[c] holds rows values of column c
+    void WriteGroup(const std::vector<std::vector<double>>& columns, size_t rows);
+
+    long long GetRowCount() const;
+
+private:
+
+    std::ofstream file;
+    size_t columnCount;
+    long long rowCount = 0;
+};
+
+// Reads a whole ColumnarWriter file, concatenating the groups of each column.
+// Returns false if the file is missing, truncated or not in this format.
+bool ReadColumnarFile(const std::string& path, std::vector<std::string>& names, std::vector<std::vector<double>>& columns);
@@ -0,0 +1,136 @@
+#include "EnsembleSolver.h"
+#include "Tracer.h"
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+template <typename T>
+EnsembleSolver<T>::EnsembleSolver(int threads) : scheduler(threads)
+{
+    for (int worker = 0; worker < scheduler.GetThreadCount(); worker++)
+    {
+        solvers.push_back(std::make_unique<RungeKuttaSolver<T>>());
+    }
+}
+
+template <typename T>
+bool EnsembleSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return solvers[0]->IsExpressionValid(expression_str);
+}
+
+template <typename T>
+void EnsembleSolver<T>::SetMethod(Method method)
+{
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        solver->SetMethod(method);
+    }
+}
+
+template <typename T>
+void EnsembleSolver<T>::SetTolerance(const T& tolerance)
+{
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        solver->SetTolerance(tolerance);
+    }
+}
+
+template <typename T>
+void EnsembleSolver<T>::SetChunkSize(int chunkSize)
+{
+    this->chunkSize = chunkSize;
+}
+
+template <typename T>
+void EnsembleSolver<T>::SetStealing(bool enabled)
+{
+    scheduler.SetStealing(enabled);
+}
+
+template <typename T>
+const SolverStats& EnsembleSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+const std::vector<long long>& EnsembleSolver<T>::GetWorkerEvaluations() const
+{
+    return workerEvaluations;
+}
+
+template <typename T>
+const SchedulerStats& EnsembleSolver<T>::GetSchedulerStats() const
+{
+    return scheduler.GetStats();
+}
+
+template <typename T>
+void EnsembleSolver<T>::Solve(const std::vector<EnsembleMember<T>>& members, const std::string& expr,
+    std::vector<std::vector<std::vector<T>>>& out)
+{
+    // Compile every worker's copy up front so an invalid expression throws here
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        if (!solver->IsExpressionValid(expr))
+        {
+            throw std::runtime_error("Invalid expression: " + expr);
+        }
+    }
+
+    TraceSpan solveSpan("ensemble");
+
+    const int threads = scheduler.GetThreadCount();
+    out.resize(members.size());
+    workerStats.assign(threads, SolverStats());
+    workerEvaluations.assign(threads, 0);
+
+    // A failing member must not escape a worker thread; the first error is rethrown here
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    scheduler.Run(int(members.size()), chunkSize, [&](int worker, int index)
+        {
+            const EnsembleMember<T>& member = members[index];
+            RungeKuttaSolver<T>& solver = *solvers[worker];
+            try
+            {
+                solver.Solve(member.y0, member.h, member.t, member.t0, expr, out[index]);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                return;
+            }
+
+            const SolverStats& memberStats = solver.GetStats();
+            SolverStats& total = workerStats[worker];
+            total.steps += memberStats.steps;
+            total.rejectedSteps += memberStats.rejectedSteps;
+            total.evaluations += memberStats.evaluations;
+        });
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    stats = SolverStats();
+    for (int worker = 0; worker < threads; worker++)
+    {
+        stats.steps += workerStats[worker].steps;
+        stats.rejectedSteps += workerStats[worker].rejectedSteps;
+        stats.evaluations += workerStats[worker].evaluations;
+        workerEvaluations[worker] = workerStats[worker].evaluations;
+    }
+}
+
+template class EnsembleSolver<float>;
+template class EnsembleSolver<double>;
+template class EnsembleSolver<long double>;
@@ -0,0 +1,64 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "RungeKuttaSolver.h"
+#include "SolverStats.h"
+#include "WorkStealingScheduler.h"
+
+// Initial value, step (initial step when adaptive) and time span of one ensemble member
+template <typename T>
+struct EnsembleMember
+{
+    T y0;
+    T h;
+    T t0;
+    T t;
+};
+
+// Solves many independent trajectories of the same expression on a
+// WorkStealingScheduler. Every worker owns a RungeKuttaSolver, and with it a
+// compiled copy of the expression, since exprtk expressions keep their
+// variables inside and cannot be evaluated from two threads at once.
+template <typename T>
+class EnsembleSolver
+{
+public:
+
+    // 0 threads uses one per hardware thread
+    explicit EnsembleSolver(int threads = 0);
+
+    // out[m] receives the trajectory of member m as RungeKuttaSolver::Solve writes it
+    void Solve(const std::vector<EnsembleMember<T>>& members, const std::string& expr,
+        std::vector<std::vector<std::vector<T>>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    void SetMethod(Method method);
+
+    void SetTolerance(const T& tolerance);
+
+    // Members per scheduled chunk
+    void SetChunkSize(int chunkSize);
+
+    // Off gives a static split of the members across the workers
+    void SetStealing(bool enabled);
+
+    // Totals over all members
+    const SolverStats& GetStats() const;
+
+    // Evaluations done by each worker, a measure of load balance that does not
+    // depend on how the OS shares cores between the threads
+    const std::vector<long long>& GetWorkerEvaluations() const;
+
+    const SchedulerStats& GetSchedulerStats() const;
+
+private:
+
+    WorkStealingScheduler scheduler;
+    std::vector<std::unique_ptr<RungeKuttaSolver<T>>> solvers;
+    std::vector<SolverStats> workerStats;
+    std::vector<long long> workerEvaluations;
+    int chunkSize = 4;
+    SolverStats stats;
+};
@@ -0,0 +1,169 @@
+#include "EventSet.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // A zero at the end of a step counts as a crossing; a zero at the start
+    // was already reported by the previous step
+    template <typename T>
+    bool ChangedSign(const T& before, const T& after)
+    {
+        return (before < 0 && after >= 0) || (before > 0 && after <= 0);
+    }
+}
+
+template <typename T>
+EventSet<T>::EventSet()
+{
+}
+
+template <typename T>
+bool EventSet<T>::Add(const std::string& expression, EventAction action)
+{
+    std::unique_ptr<OdeExpression<T>> function = std::make_unique<OdeExpression<T>>();
+    if (!function->Compile(expression))
+    {
+        return false;
+    }
+    functions.push_back(std::move(function));
+    actions.push_back(action);
+    return true;
+}
+
+template <typename T>
+void EventSet<T>::Clear()
+{
+    functions.clear();
+    actions.clear();
+    records.clear();
+}
+
+template <typename T>
+bool EventSet<T>::IsEmpty() const
+{
+    return functions.empty();
+}
+
+template <typename T>
+void EventSet<T>::Start(const T& t, const T& y)
+{
+    records.clear();
+    previous.resize(functions.size());
+    current.resize(functions.size());
+    for (size_t event = 0; event < functions.size(); event++)
+    {
+        previous[event] = functions[event]->Evaluate(t, y);
+    }
+}
+
+template <typename T>
+bool EventSet<T>::Crossed(const T& t, const T& y)
+{
+    bool crossed = false;
+    for (size_t event = 0; event < functions.size(); event++)
+    {
+        current[event] = functions[event]->Evaluate(t, y);
+        crossed = crossed || ChangedSign(previous[event], current[event]);
+    }
+    if (!crossed)
+    {
+        previous.swap(current);
+    }
+    return crossed;
+}
+
+template <typename T>
+bool EventSet<T>::Locate(const HermiteSegment<T>& segment, T& t, T& y)
+{
+    std::vector<EventRecord<T>> found;
+    for (size_t event = 0; event < functions.size(); event++)
+    {
+        if (ChangedSign(previous[event], current[event]))
+        {
+            const T time = FindRoot(int(event), segment);
+            found.push_back({ int(event), time, segment.Value(time), actions[event] == EventAction::Terminate });
+        }
+    }
+    std::stable_sort(found.begin(), found.end(), [](const EventRecord<T>& a, const EventRecord<T>& b) { return a.t < b.t; });
+
+    previous.swap(current);
+    for (const EventRecord<T>& record : found)
+    {
+        records.push_back(record);
+        if (record.terminal)
+        {
+            t = record.t;
+            y = record.y;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+const std::vector<EventRecord<T>>& EventSet<T>::GetRecords() const
+{
+    return records;
+}
+
+// Illinois method: regula falsi on g(t, y(t)) along the interpolant, halving
+// the value kept at an end point that is retained twice in a row so that the
+// bracket shrinks from both sides. Returns the end of the final bracket on
+// which g has its new sign.
+template <typename T>
+T EventSet<T>::FindRoot(int event, const HermiteSegment<T>& segment)
+{
+    OdeExpression<T>& g = *functions[event];
+    T a = segment.t0;
+    T b = segment.t1;
+    T ga = previous[event];
+    T gb = current[event];
+    int retained = 0;
+
+    for (int iteration = 0; iteration < MaxIterations && gb != 0; iteration++)
+    {
+        if (b - a <= 4 * std::numeric_limits<T>::epsilon() * std::max(T(1), std::fabs(b)))
+        {
+            break;
+        }
+
+        T c = (a * gb - b * ga) / (gb - ga);
+        if (!(c > a && c < b))
+        {
+            c = (a + b) / 2;
+        }
+
+        const T gc = g.Evaluate(c, segment.Value(c));
+        if (gc == 0)
+        {
+            return c;
+        }
+        if ((gc < 0) == (gb < 0))
+        {
+            b = c;
+            gb = gc;
+            if (retained < 0)
+            {
+                ga /= 2;
+            }
+            retained = -1;
+        }
+        else
+        {
+            a = c;
+            ga = gc;
+            if (retained > 0)
+            {
+                gb /= 2;
+            }
+            retained = 1;
+        }
+    }
+    return b;
+}
+
+template class EventSet<float>;
+template class EventSet<double>;
+template class EventSet<long double>;
@@ -0,0 +1,71 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "DenseOutput.h"
+#include "OdeExpression.h"
+
+// Terminal events stop the integration at the event; others are only recorded
+enum class EventAction
+{
+    Record,
+    Terminate,
+};
+
+// An event function that changed sign, with the localized time and state
+template <typename T>
+struct EventRecord
+{
+    int event;
+    T t;
+    T y;
+    bool terminal;
+};
+
+// Event functions g(t, y), compiled by exprtk like the right-hand side, that
+// are watched for sign changes between accepted steps. Detection only needs g
+// at the step ends; a crossing is then localized on the step's dense output
+// with the Illinois variant of regula falsi, which costs event evaluations
+// but no evaluations of f.
+template <typename T>
+class EventSet
+{
+public:
+
+    EventSet();
+
+    // Returns false if the expression is invalid
+    bool Add(const std::string& expression, EventAction action);
+
+    void Clear();
+
+    bool IsEmpty() const;
+
+    // Evaluates the event functions at the initial point and forgets earlier records
+    void Start(const T& t, const T& y);
+
+    // Evaluates the event functions at the end of a step. Returns true if any
+    // changed sign over the step, in which case Locate must be called with the
+    // step's interpolant before the next step.
+    bool Crossed(const T& t, const T& y);
+
+    // Localizes the crossings found by Crossed and records them in time order
+    // up to the first terminal one. Returns true if a terminal event fired,
+    // with its time and state in t and y.
+    bool Locate(const HermiteSegment<T>& segment, T& t, T& y);
+
+    // Events fired since Start
+    const std::vector<EventRecord<T>>& GetRecords() const;
+
+private:
+
+    static const int MaxIterations = 60;
+
+    T FindRoot(int event, const HermiteSegment<T>& segment);
+
+    std::vector<std::unique_ptr<OdeExpression<T>>> functions;
+    std::vector<EventAction> actions;
+    std::vector<T> previous;
+    std::vector<T> current;
+    std::vector<EventRecord<T>> records;
+};
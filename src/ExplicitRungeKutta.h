@@ -0,0 +1,59 @@
+#pragma once
+#include <utility>
+
+// One step of the explicit Runge-Kutta method described by Tableau. The stage
+// loop is expanded at compile time with fold expressions, so every coefficient
+// is a literal in the generated code and there is no per-stage loop or lookup.
+template <typename Tableau, typename T>
+class ExplicitRungeKutta
+{
+public:
+
+    static constexpr int Stages = Tableau::Stages;
+
+    // Advances y from t by h. k0 is f(t, y), which the caller supplies so that
+    // FSAL pairs can pass the previous step's last stage. kLast receives the
+    // last stage, and error the embedded error estimate (zero if not embedded).
+    template <typename F>
+    static T Step(F& f, const T& t, const T& y, const T& h, const T& k0, T& kLast, T& error)
+    {
+        return StepStages(f, t, y, h, k0, kLast, error, std::make_index_sequence<Stages>());
+    }
+
+private:
+
+    template <typename F, std::size_t... S>
+    static T StepStages(F& f, const T& t, const T& y, const T& h, const T& k0, T& kLast, T& error, std::index_sequence<S...>)
+    {
+        T k[Stages];
+        k[0] = k0;
+        (EvaluateStage<S>(f, t, y, h, k), ...);
+
+        kLast = k[Stages - 1];
+        if constexpr (Tableau::Embedded)
+        {
+            error = h * (T(0) + ... + (T(Tableau::E[S]) * k[S]));
+        }
+        else
+        {
+            error = T(0);
+        }
+
+        return y + h * (T(0) + ... + (T(Tableau::B[S]) * k[S]));
+    }
+
+    template <std::size_t S, typename F>
+    static void EvaluateStage(F& f, const T& t, const T& y, const T& h, T* k)
+    {
+        if constexpr (S > 0)
+        {
+            k[S] = f(t + T(Tableau::C[S]) * h, y + h * StageSum<S>(k, std::make_index_sequence<S>()));
+        }
+    }
+
+    template <std::size_t S, std::size_t... J>
+    static T StageSum(const T* k, std::index_sequence<J...>)
+    {
+        return (T(0) + ... + (T(Tableau::A[S][J]) * k[J]));
+    }
+};
@@ -0,0 +1,390 @@
+#include "ExpressionTape.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+// Recursive descent parser following exprtk's precedence: + and - bind
+// loosest, then * and /, unary minus, and ^ (right associative) tightest.
+// Nodes are appended to the tape as they are parsed, so operands always come
+// before the nodes that use them.
+template <typename T>
+struct ExpressionTape<T>::Parser
+{
+    // Integer powers up to this are expanded into products
+    static const int MaxExpandedPower = 64;
+
+    Parser(const std::string& text, const std::vector<std::string>& parameters, std::vector<Node>& tape)
+        : text(text), parameters(parameters), tape(tape)
+    {
+    }
+
+    // Tape index of the result, or -1 if the text is not a supported expression
+    int Parse()
+    {
+        const int result = Sum();
+        SkipSpace();
+        return failed || position != text.size() ? -1 : result;
+    }
+
+    int Sum()
+    {
+        int left = Product();
+        while (!failed)
+        {
+            if (Accept('+'))
+            {
+                left = Binary(Op::Add, left, Product());
+            }
+            else if (Accept('-'))
+            {
+                left = Binary(Op::Subtract, left, Product());
+            }
+            else
+            {
+                break;
+            }
+        }
+        return left;
+    }
+
+    int Product()
+    {
+        int left = Signed();
+        while (!failed)
+        {
+            if (Accept('*'))
+            {
+                left = Binary(Op::Multiply, left, Signed());
+            }
+            else if (Accept('/'))
+            {
+                left = Binary(Op::Divide, left, Signed());
+            }
+            else
+            {
+                break;
+            }
+        }
+        return left;
+    }
+
+    int Signed()
+    {
+        if (Accept('-'))
+        {
+            return Unary(Op::Negate, Signed());
+        }
+        if (Accept('+'))
+        {
+            return Signed();
+        }
+
+        const int base = Primary();
+        return Accept('^') ? Raise(base, Signed()) : base;
+    }
+
+    int Primary()
+    {
+        SkipSpace();
+        if (position >= text.size())
+        {
+            return Fail();
+        }
+
+        const char c = text[position];
+        if (std::isdigit((unsigned char)c) || c == '.')
+        {
+            const char* start = text.c_str() + position;
+            char* end = nullptr;
+            const long double value = std::strtold(start, &end);
+            if (end == start)
+            {
+                return Fail();
+            }
+            position += end - start;
+            return Constant(T(value));
+        }
+
+        if (Accept('('))
+        {
+            const int inner = Sum();
+            return Accept(')') ? inner : Fail();
+        }
+
+        if (!std::isalpha((unsigned char)c) && c != '_')
+        {
+            return Fail();
+        }
+
+        // exprtk identifiers are case insensitive
+        std::string name;
+        while (position < text.size() && (std::isalnum((unsigned char)text[position]) || text[position] == '_'))
+        {
+            name += char(std::tolower((unsigned char)text[position++]));
+        }
+
+        if (!Accept('('))
+        {
+            if (name == "t")
+            {
+                return Push(Op::Time, -1, -1, T(0));
+            }
+            if (name == "y")
+            {
+                return Push(Op::State, -1, -1, T(0));
+            }
+            if (name == "pi")
+            {
+                return Constant(T(3.141592653589793238462643383279502L));
+            }
+            if (name == "epsilon")
+            {
+                return Constant(std::numeric_limits<T>::epsilon());
+            }
+            for (size_t index = 0; index < parameters.size(); index++)
+            {
+                if (name == Lowercase(parameters[index]))
+                {
+                    return Push(Op::Parameter, -1, -1, T(index));
+                }
+            }
+            return Fail();
+        }
+
+        const int first = Sum();
+        if (name == "pow")
+        {
+            if (!Accept(','))
+            {
+                return Fail();
+            }
+            const int second = Sum();
+            return Accept(')') ? Raise(first, second) : Fail();
+        }
+        if (!Accept(')'))
+        {
+            return Fail();
+        }
+
+        static const struct { const char* name; Op op; } functions[] =
+        {
+            { "exp", Op::Exp }, { "log", Op::Log }, { "sqrt", Op::Sqrt },
+            { "sin", Op::Sin }, { "cos", Op::Cos }, { "tan", Op::Tan },
+            { "sinh", Op::Sinh }, { "cosh", Op::Cosh },
+        };
+        for (const auto& function : functions)
+        {
+            if (name == function.name)
+            {
+                return Unary(function.op, first);
+            }
+        }
+        return Fail();
+    }
+
+    int Push(Op op, int left, int right, const T& value)
+    {
+        if (failed)
+        {
+            return -1;
+        }
+        tape.push_back({ op, left, right, value });
+        return int(tape.size()) - 1;
+    }
+
+    int Constant(const T& value)
+    {
+        return Push(Op::Constant, -1, -1, value);
+    }
+
+    bool IsConstant(int n) const
+    {
+        return tape[n].op == Op::Constant;
+    }
+
+    int Unary(Op op, int operand)
+    {
+        if (failed)
+        {
+            return -1;
+        }
+        if (IsConstant(operand))
+        {
+            return Constant(Fold(op, tape[operand].value, T(0)));
+        }
+        return Push(op, operand, -1, T(0));
+    }
+
+    int Binary(Op op, int left, int right)
+    {
+        if (failed)
+        {
+            return -1;
+        }
+        if (IsConstant(left) && IsConstant(right))
+        {
+            return Constant(Fold(op, tape[left].value, tape[right].value));
+        }
+        return Push(op, left, right, T(0));
+    }
+
+    int Raise(int base, int exponent)
+    {
+        if (failed)
+        {
+            return -1;
+        }
+
+        // A variable exponent goes through a^b = exp(b log a)
+        if (!IsConstant(exponent))
+        {
+            return Unary(Op::Exp, Binary(Op::Multiply, exponent, Unary(Op::Log, base)));
+        }
+
+        const T power = tape[exponent].value;
+        if (IsConstant(base))
+        {
+            return Constant(std::pow(tape[base].value, power));
+        }
+        if (power != std::floor(power) || std::fabs(power) > MaxExpandedPower)
+        {
+            return Push(Op::Power, base, -1, power);
+        }
+
+        // Products by repeated squaring stay exact where the base passes
+        // through zero, which the general power recurrence divides by
+        int result = -1;
+        int square = base;
+        for (long n = long(std::fabs(power)); n > 0; n >>= 1)
+        {
+            if (n & 1)
+            {
+                result = result < 0 ? square : Binary(Op::Multiply, result, square);
+            }
+            if (n > 1)
+            {
+                square = Binary(Op::Multiply, square, square);
+            }
+        }
+        if (result < 0)
+        {
+            return Constant(T(1));
+        }
+        return power < 0 ? Binary(Op::Divide, Constant(T(1)), result) : result;
+    }
+
+    static T Fold(Op op, const T& a, const T& b)
+    {
+        switch (op)
+        {
+        case Op::Add: return a + b;
+        case Op::Subtract: return a - b;
+        case Op::Multiply: return a * b;
+        case Op::Divide: return a / b;
+        case Op::Negate: return -a;
+        case Op::Exp: return std::exp(a);
+        case Op::Log: return std::log(a);
+        case Op::Sqrt: return std::sqrt(a);
+        case Op::Sin: return std::sin(a);
+        case Op::Cos: return std::cos(a);
+        case Op::Tan: return std::tan(a);
+        case Op::Sinh: return std::sinh(a);
+        case Op::Cosh: return std::cosh(a);
+        default: return a;
+        }
+    }
+
+    void SkipSpace()
+    {
+        while (position < text.size() && std::isspace((unsigned char)text[position]))
+        {
+            position++;
+        }
+    }
+
+    bool Accept(char c)
+    {
+        SkipSpace();
+        if (position < text.size() && text[position] == c)
+        {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    int Fail()
+    {
+        failed = true;
+        return -1;
+    }
+
+    static std::string Lowercase(std::string name)
+    {
+        for (char& c : name)
+        {
+            c = char(std::tolower((unsigned char)c));
+        }
+        return name;
+    }
+
+    const std::string& text;
+    const std::vector<std::string>& parameters;
+    std::vector<Node>& tape;
+    size_t position = 0;
+    bool failed = false;
+};
+
+template <typename T>
+ExpressionTape<T>::ExpressionTape()
+{
+}
+
+template <typename T>
+bool ExpressionTape<T>::Compile(const std::string& expression, const std::vector<std::string>& parameters)
+{
+    nodes.clear();
+    Parser parser(expression, parameters, nodes);
+    root = parser.Parse();
+    if (root < 0)
+    {
+        nodes.clear();
+    }
+    return root >= 0;
+}
+
+template <typename T>
+bool ExpressionTape<T>::IsParameterName(const std::string& name)
+{
+    if (name.empty() || !(std::isalpha((unsigned char)name[0]) || name[0] == '_'))
+    {
+        return false;
+    }
+    for (char c : name)
+    {
+        if (!std::isalnum((unsigned char)c) && c != '_')
+        {
+            return false;
+        }
+    }
+    const std::string lower = Parser::Lowercase(name);
+    return lower != "t" && lower != "y" && lower != "pi" && lower != "epsilon";
+}
+
+template <typename T>
+const std::vector<typename ExpressionTape<T>::Node>& ExpressionTape<T>::GetNodes() const
+{
+    return nodes;
+}
+
+template <typename T>
+int ExpressionTape<T>::GetRoot() const
+{
+    return root;
+}
+
+template class ExpressionTape<float>;
+template class ExpressionTape<double>;
+template class ExpressionTape<long double>;
@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Right-hand side f(t, y) parsed into a flat tape of operations in evaluation
+// order. exprtk does not expose its expression tree, so the expression is
+// parsed again here, with exprtk's syntax for the analytic subset of its
+// operators: + - * / ^, parentheses, t, y, pi and the functions exp, log,
+// sqrt, sin, cos, tan, sinh, cosh and pow. Constant subexpressions are folded
+// and integer powers expanded into products. The tape is what the Taylor and
+// lane-batched evaluators walk instead of exprtk's scalar tree.
+template <typename T>
+class ExpressionTape
+{
+public:
+
+    enum class Op
+    {
+        Constant,
+        Time,
+        State,
+        Parameter,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Negate,
+        Exp,
+        Log,
+        Sqrt,
+        Sin,
+        Cos,
+        Tan,
+        Sinh,
+        Cosh,
+        Power,
+    };
+
+    // Operands are earlier tape entries; Power raises left to the constant
+    // value, and Parameter stands for the parameter whose index is value
+    struct Node
+    {
+        Op op;
+        int left;
+        int right;
+        T value;
+    };
+
+    ExpressionTape();
+
+    // Returns false and leaves the tape empty if the expression is invalid or
+    // uses an operator outside the supported subset. Identifiers matching a
+    // parameter name become Parameter nodes, which the caller supplies values
+    // for; they are never folded into constants.
+    bool Compile(const std::string& expression, const std::vector<std::string>& parameters = std::vector<std::string>());
+
+    // Whether name can be a parameter: an identifier other than t, y, pi and epsilon
+    static bool IsParameterName(const std::string& name);
+
+    const std::vector<Node>& GetNodes() const;
+
+    // Tape index of the result, -1 when nothing is compiled
+    int GetRoot() const;
+
+private:
+
+    struct Parser;
+
+    std::vector<Node> nodes;
+    int root = -1;
+};
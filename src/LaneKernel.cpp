@@ -0,0 +1,12 @@
+#include "LaneKernel.h"
+
+// Baseline build, for any CPU the rest of the program runs on
+template <typename T>
+void IntegrateLanesScalar(BatchExpression<T>& f, LaneBlock<T>& block)
+{
+    IntegrateLanes(f, block);
+}
+
+template void IntegrateLanesScalar<float>(BatchExpression<float>& f, LaneBlock<float>& block);
+template void IntegrateLanesScalar<double>(BatchExpression<double>& f, LaneBlock<double>& block);
+template void IntegrateLanesScalar<long double>(BatchExpression<long double>& f, LaneBlock<long double>& block);
@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include "BatchExpression.h"
+#include "ButcherTableau.h"
+#include "SimdDispatch.h"
+
+// Lane state of one block. Steps are held as T so the comparison that
+// zeroes the step of finished lanes vectorises with the arithmetic.
+template <typename T, int Lanes = BatchExpression<T>::Lanes>
+struct LaneBlock
+{
+    alignas(64) T t0[Lanes];
+    alignas(64) T h[Lanes];
+    alignas(64) T steps[Lanes];
+    alignas(64) T y[Lanes];
+    long long maxSteps = 0;
+};
+
+// RK4 on every lane with the coefficients and operation order of
+// ExplicitRungeKutta<Rk4Tableau>, so each lane matches RungeKuttaSolver
+// up to the multiply-adds the AVX targets may fuse. Static, so each level's
+// source file keeps its own copy and the linker cannot swap in a wider one.
+template <typename T, int Lanes>
+static SIMD_INLINE void IntegrateLanes(BatchExpression<T>& f, LaneBlock<T, Lanes>& block)
+{
+    const T c1 = T(Rk4Tableau::C[1]), c3 = T(Rk4Tableau::C[3]);
+    const T a10 = T(Rk4Tableau::A[1][0]), a21 = T(Rk4Tableau::A[2][1]), a32 = T(Rk4Tableau::A[3][2]);
+    const T b0 = T(Rk4Tableau::B[0]), b1 = T(Rk4Tableau::B[1]), b2 = T(Rk4Tableau::B[2]), b3 = T(Rk4Tableau::B[3]);
+
+    alignas(64) T time[Lanes], stageTime[Lanes], stage[Lanes], h[Lanes], lastStep[Lanes];
+    alignas(64) T k0[Lanes], k1[Lanes], k2[Lanes], k3[Lanes];
+    T* y = block.y;
+
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        lastStep[lane] = std::max(block.steps[lane] - T(1), T(0));
+    }
+
+    for (long long step = 0; step < block.maxSteps; step++)
+    {
+        // Time is recomputed from the step index, as RungeKuttaSolver does.
+        // Finished lanes stay at their last step so f is never evaluated
+        // past a member's final time
+        const T index = T(step);
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            h[lane] = index < block.steps[lane] ? block.h[lane] : T(0);
+            time[lane] = block.t0[lane] + std::min(index, lastStep[lane]) * block.h[lane];
+        }
+
+        f.Evaluate(time, y, k0);
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            stageTime[lane] = time[lane] + c1 * h[lane];
+            stage[lane] = y[lane] + h[lane] * (a10 * k0[lane]);
+        }
+        f.Evaluate(stageTime, stage, k1);
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            stage[lane] = y[lane] + h[lane] * (a21 * k1[lane]);
+        }
+        f.Evaluate(stageTime, stage, k2);
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            stageTime[lane] = time[lane] + c3 * h[lane];
+            stage[lane] = y[lane] + h[lane] * (a32 * k2[lane]);
+        }
+        f.Evaluate(stageTime, stage, k3);
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            // Select rather than add 0*k, which is NaN if f overflowed
+            const T next = y[lane] + h[lane] * (b0 * k0[lane] + b1 * k1[lane] + b2 * k2[lane] + b3 * k3[lane]);
+            y[lane] = index < block.steps[lane] ? next : y[lane];
+        }
+    }
+}
+
+// The kernel built once per SimdLevel, each in its own source file so MSVC
+// can compile it with that level's /arch. Only the scalar build exists
+// without SIMD_DISPATCH. GCC treats a target attribute missing from a
+// declaration as another version of the function, so both carry it.
+template <typename T>
+void IntegrateLanesScalar(BatchExpression<T>& f, LaneBlock<T>& block);
+
+template <typename T>
+SIMD_TARGET_AVX2 void IntegrateLanesAvx2(BatchExpression<T>& f, LaneBlock<T>& block);
+
+template <typename T>
+SIMD_TARGET_AVX512 void IntegrateLanesAvx512(BatchExpression<T>& f, LaneBlock<T>& block);
@@ -0,0 +1,17 @@
+#include "LaneKernel.h"
+
+#if SIMD_DISPATCH
+
+// GCC and Clang take the target from the attribute; the MSVC project builds
+// this file with /arch:AVX2. Only called when DetectSimdLevel allows it.
+template <typename T>
+SIMD_TARGET_AVX2 void IntegrateLanesAvx2(BatchExpression<T>& f, LaneBlock<T>& block)
+{
+    IntegrateLanes(f, block);
+}
+
+template void IntegrateLanesAvx2<float>(BatchExpression<float>& f, LaneBlock<float>& block);
+template void IntegrateLanesAvx2<double>(BatchExpression<double>& f, LaneBlock<double>& block);
+template void IntegrateLanesAvx2<long double>(BatchExpression<long double>& f, LaneBlock<long double>& block);
+
+#endif
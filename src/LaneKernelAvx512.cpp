@@ -0,0 +1,17 @@
+#include "LaneKernel.h"
+
+#if SIMD_DISPATCH
+
+// GCC and Clang take the target from the attribute; the MSVC project builds
+// this file with /arch:AVX512. Only called when DetectSimdLevel allows it.
+template <typename T>
+SIMD_TARGET_AVX512 void IntegrateLanesAvx512(BatchExpression<T>& f, LaneBlock<T>& block)
+{
+    IntegrateLanes(f, block);
+}
+
+template void IntegrateLanesAvx512<float>(BatchExpression<float>& f, LaneBlock<float>& block);
+template void IntegrateLanesAvx512<double>(BatchExpression<double>& f, LaneBlock<double>& block);
+template void IntegrateLanesAvx512<long double>(BatchExpression<long double>& f, LaneBlock<long double>& block);
+
+#endif
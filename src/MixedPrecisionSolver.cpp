@@ -0,0 +1,62 @@
+#include "MixedPrecisionSolver.h"
+#include "Tracer.h"
+#include <cmath>
+#include <stdexcept>
+
+template <typename State>
+MixedPrecisionSolver<State>::MixedPrecisionSolver()
+{
+}
+
+template <typename State>
+bool MixedPrecisionSolver<State>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str);
+}
+
+// Same contract as RungeKuttaSolver::Solve, with the precision split described in the header
+template <typename State>
+void MixedPrecisionSolver<State>::Solve(const double& y0, const double& h, const double& t, const double& t0, const std::string& expr, std::vector<std::vector<double>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    if (!expression.Compile(expr))
+    {
+        throw std::runtime_error("Invalid expression: " + expr);
+    }
+
+    const int x = int(std::ceil((t - t0) / h)) + 1;
+    out.resize(x, std::vector<double>(2));
+
+    const float hf = float(h);
+    State w = y0;
+    float k1, k2, k3, k4;
+    double i = t0;
+    int index = 0;
+    const int steps = x - 1;
+
+    TraceSpan solveSpan("solve");
+    while (index < steps)
+    {
+        out[index] = { i, double(w) };
+
+        const double y = double(w);
+        k1 = hf * dydt(i, y);
+        k2 = hf * dydt(i + h/2, y + k1/2);
+        k3 = hf * dydt(i + h/2, y + k2/2);
+        k4 = hf * dydt(i + h, y + k3);
+
+        w += (k1 + 2*k2 + 2*k3 + k4) / 6;
+
+        index++;
+        i = t0 + index * h;
+    }
+
+    out[index] = { i, double(w) };
+}
+
+template class MixedPrecisionSolver<double>;
+template class MixedPrecisionSolver<CompensatedFloat>;
@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "OdeExpression.h"
+
+// Float accumulator with Kahan compensation: the low bits lost by each
+// addition are carried into the next one, so long sums of small increments
+// keep close to double accuracy at float storage cost.
+struct CompensatedFloat
+{
+    float sum = 0.0f;
+    float compensation = 0.0f;
+
+    CompensatedFloat() = default;
+
+    CompensatedFloat(double value) : sum(float(value)), compensation(float(double(sum) - value))
+    {
+    }
+
+    CompensatedFloat& operator+=(float value)
+    {
+        const float corrected = value - compensation;
+        const float next = sum + corrected;
+        compensation = (next - sum) - corrected;
+        sum = next;
+        return *this;
+    }
+
+    operator double() const
+    {
+        return double(sum) - double(compensation);
+    }
+};
+
+// RK4 that evaluates the right-hand side and the stage increments in float
+// while the state is accumulated in State (double or CompensatedFloat). Time
+// is computed as t0 + index * h, so it does not drift over long runs.
+template <typename State>
+class MixedPrecisionSolver
+{
+public:
+
+    MixedPrecisionSolver();
+
+    void Solve(const double& y0, const double& h, const double& t, const double& t0,
+        const std::string& expr, std::vector<std::vector<double>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+private:
+
+    float dydt(const double& t, const double& y)
+    {
+        return expression.Evaluate(float(t), float(y));
+    }
+
+    OdeExpression<float> expression;
+};
@@ -0,0 +1,137 @@
+#include "OdeExpression.h"
+#include "Tracer.h"
+#include "exprtk.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+template <typename T>
+struct OdeExpression<T>::Impl
+{
+    exprtk::symbol_table<T> symbolTable;
+    exprtk::expression<T> expression;
+    std::string source;
+    bool compiled = false;
+    T t = T(0);
+    T y = T(0);
+
+    // Map nodes never move, so exprtk can keep references to the values
+    std::map<std::string, T> parameters;
+};
+
+template <typename T>
+OdeExpression<T>::OdeExpression() : impl(std::make_unique<Impl>())
+{
+    impl->symbolTable.add_variable("t", impl->t);
+    impl->symbolTable.add_variable("y", impl->y);
+    impl->symbolTable.add_constants();
+    impl->expression.register_symbol_table(impl->symbolTable);
+}
+
+template <typename T>
+OdeExpression<T>::~OdeExpression() = default;
+
+// Parses the expression; returns false and leaves nothing compiled if it is invalid.
+// Recompiling the expression that is already compiled is a no-op.
+template <typename T>
+bool OdeExpression<T>::Compile(const std::string& expression)
+{
+    if (impl->compiled && impl->source == expression)
+    {
+        return true;
+    }
+
+    TraceSpan span("compile");
+
+    exprtk::parser<T> parser;
+    impl->compiled = parser.compile(expression, impl->expression);
+    impl->source = impl->compiled ? expression : std::string();
+    return impl->compiled;
+}
+
+template <typename T>
+bool OdeExpression<T>::SetParameter(const std::string& name, const T& value)
+{
+    auto found = impl->parameters.find(name);
+    if (found != impl->parameters.end())
+    {
+        found->second = value;
+        return true;
+    }
+
+    T& stored = impl->parameters[name];
+    stored = value;
+    if (!impl->symbolTable.add_variable(name, stored))
+    {
+        impl->parameters.erase(name);
+        return false;
+    }
+
+    // The compiled expression resolved its symbols without this one
+    impl->compiled = false;
+    return true;
+}
+
+template <typename T>
+bool OdeExpression<T>::GetParameter(const std::string& name, T& value) const
+{
+    auto found = impl->parameters.find(name);
+    if (found == impl->parameters.end())
+    {
+        return false;
+    }
+    value = found->second;
+    return true;
+}
+
+template <typename T>
+std::vector<std::pair<std::string, T>> OdeExpression<T>::GetParameters() const
+{
+    return std::vector<std::pair<std::string, T>>(impl->parameters.begin(), impl->parameters.end());
+}
+
+template <typename T>
+bool OdeExpression<T>::IsCompiled() const
+{
+    return impl->compiled;
+}
+
+template <typename T>
+const std::string& OdeExpression<T>::GetExpression() const
+{
+    return impl->source;
+}
+
+template <typename T>
+T OdeExpression<T>::Evaluate(const T& t, const T& y)
+{
+    impl->t = t;
+    impl->y = y;
+    return impl->expression.value();
+}
+
+namespace
+{
+    // Difference step for exprtk::derivative's five point stencil, balancing
+    // truncation (O(step^4)) against rounding (O(eps / step))
+    template <typename T>
+    T DifferenceStep(const T& x)
+    {
+        static const T scale = std::pow(std::numeric_limits<T>::epsilon(), T(0.2));
+        return scale * std::max(T(1), std::fabs(x));
+    }
+}
+
+// df/dy at (t, y); costs four evaluations
+template <typename T>
+T OdeExpression<T>::PartialY(const T& t, const T& y)
+{
+    impl->t = t;
+    impl->y = y;
+    return exprtk::derivative(impl->expression, impl->y, DifferenceStep(y));
+}
+
+template class OdeExpression<float>;
+template class OdeExpression<double>;
+template class OdeExpression<long double>;
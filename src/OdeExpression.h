@@ -0,0 +1,48 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Right-hand side f(t, y) of a first order ODE, parsed once by exprtk and then
+// evaluated repeatedly. exprtk is only included by OdeExpression.cpp, which
+// instantiates this for float, double and long double.
+template <typename T>
+class OdeExpression
+{
+public:
+
+    OdeExpression();
+    ~OdeExpression();
+
+    OdeExpression(const OdeExpression&) = delete;
+    OdeExpression& operator=(const OdeExpression&) = delete;
+
+    bool Compile(const std::string& expression);
+
+    // Binds name to a variable held here, so expressions can use it next to
+    // t and y. Setting a known parameter only stores the value, which the
+    // compiled expression reads on its next evaluation; a new name takes
+    // effect at the next Compile. Returns false for names exprtk rejects,
+    // such as t, y, reserved words and functions.
+    bool SetParameter(const std::string& name, const T& value);
+
+    // Current value of a parameter, or false if it was never set
+    bool GetParameter(const std::string& name, T& value) const;
+
+    // Every parameter set so far with its value, in name order
+    std::vector<std::pair<std::string, T>> GetParameters() const;
+
+    bool IsCompiled() const;
+
+    const std::string& GetExpression() const;
+
+    T Evaluate(const T& t, const T& y);
+
+    T PartialY(const T& t, const T& y);
+
+private:
+
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
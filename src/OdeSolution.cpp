@@ -0,0 +1,126 @@
+#include "OdeSolution.h"
+#include "Tracer.h"
+#include <stdexcept>
+
+template <typename T>
+size_t Trajectory<T>::Size() const
+{
+    return size;
+}
+
+template <typename T>
+T Trajectory<T>::Time(size_t row) const
+{
+    return (*blocks[row / BlockRows])[row % BlockRows];
+}
+
+template <typename T>
+T Trajectory<T>::Value(size_t row) const
+{
+    return (*blocks[row / BlockRows])[BlockRows + row % BlockRows];
+}
+
+template <typename T>
+void Trajectory<T>::Append(const T& t, const T& y)
+{
+    const size_t block = size / BlockRows;
+    if (block == blocks.size())
+    {
+        blocks.push_back(std::make_unique<Block>());
+    }
+    Block& rows = *blocks[block];
+    rows[size % BlockRows] = t;
+    rows[BlockRows + size % BlockRows] = y;
+    size++;
+}
+
+template <typename T>
+void Trajectory<T>::Clear()
+{
+    size = 0;
+}
+
+template <typename T>
+void Trajectory<T>::CopyTo(std::vector<std::vector<T>>& out) const
+{
+    out.resize(size);
+    for (size_t row = 0; row < size; row++)
+    {
+        out[row] = { Time(row), Value(row) };
+    }
+}
+
+template <typename T>
+void OdeSolution<T>::Solve(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr)
+{
+    trajectory.Clear();
+    if (t0 >= t)
+    {
+        return;
+    }
+    solver.Solve(y0, h, t, t0, expr, rows);
+    Append();
+}
+
+template <typename T>
+void OdeSolution<T>::ExtendTo(const T& t)
+{
+    if (trajectory.Size() == 0)
+    {
+        throw std::runtime_error("Nothing to extend: Solve first");
+    }
+    if (t <= GetFinalTime())
+    {
+        return;
+    }
+
+    TraceSpan span("extend");
+    solver.Continue(t, rows);
+    Append();
+}
+
+template <typename T>
+void OdeSolution<T>::Append()
+{
+    for (const std::vector<T>& row : rows)
+    {
+        trajectory.Append(row[0], row[1]);
+    }
+}
+
+template <typename T>
+const Trajectory<T>& OdeSolution<T>::GetTrajectory() const
+{
+    return trajectory;
+}
+
+template <typename T>
+T OdeSolution<T>::GetFinalTime() const
+{
+    return trajectory.Time(trajectory.Size() - 1);
+}
+
+template <typename T>
+T OdeSolution<T>::GetFinalValue() const
+{
+    return trajectory.Value(trajectory.Size() - 1);
+}
+
+template <typename T>
+RungeKuttaSolver<T>& OdeSolution<T>::GetSolver()
+{
+    return solver;
+}
+
+template <typename T>
+const SolverStats& OdeSolution<T>::GetStats() const
+{
+    return solver.GetStats();
+}
+
+template class Trajectory<float>;
+template class Trajectory<double>;
+template class Trajectory<long double>;
+template class OdeSolution<float>;
+template class OdeSolution<double>;
+template class OdeSolution<long double>;
@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include "RungeKuttaSolver.h"
+#include "SolverStats.h"
+
+// (t, y) rows stored in fixed-size blocks. Appending only ever adds blocks,
+// so rows already stored are never moved or copied however long it grows.
+template <typename T>
+class Trajectory
+{
+public:
+
+    static const size_t BlockRows = 4096;
+
+    size_t Size() const;
+
+    T Time(size_t row) const;
+
+    T Value(size_t row) const;
+
+    void Append(const T& t, const T& y);
+
+    // Keeps the blocks for reuse
+    void Clear();
+
+    // Rows as RungeKuttaSolver::Solve writes them
+    void CopyTo(std::vector<std::vector<T>>& out) const;
+
+private:
+
+    // Times then values of each block
+    typedef std::array<T, 2 * BlockRows> Block;
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    size_t size = 0;
+};
+
+// A solution that can be carried on to later final times. It keeps its
+// RungeKuttaSolver, and with it the compiled expression and the final state,
+// so ExtendTo only integrates the new interval, on the same step grid as the
+// first Solve, and appends the new rows to the trajectory. The rows from the
+// solver go through one reused scratch buffer, so with fixed steps an
+// extension allocates nothing beyond new trajectory blocks once the buffer
+// has grown to the largest extension.
+template <typename T>
+class OdeSolution
+{
+public:
+
+    // Replaces the solution with a new run from (t0, y0) to t
+    void Solve(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr);
+
+    // Integrates from the final time to t and appends the rows; does nothing
+    // if t is not later. Throws std::runtime_error if the last run stopped at
+    // a terminal event or steady state.
+    void ExtendTo(const T& t);
+
+    const Trajectory<T>& GetTrajectory() const;
+
+    T GetFinalTime() const;
+
+    T GetFinalValue() const;
+
+    // Method, tolerance, parameters and events are set here before Solve
+    RungeKuttaSolver<T>& GetSolver();
+
+    // Totals since the last Solve
+    const SolverStats& GetStats() const;
+
+private:
+
+    void Append();
+
+    RungeKuttaSolver<T> solver;
+    Trajectory<T> trajectory;
+    std::vector<std::vector<T>> rows;
+};
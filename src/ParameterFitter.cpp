@@ -0,0 +1,313 @@
+#include "ParameterFitter.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+template <typename T>
+ParameterFitter<T>::ParameterFitter()
+{
+}
+
+template <typename T>
+bool ParameterFitter<T>::LoadData(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::vector<T> loadedTimes, loadedValues;
+    std::string line;
+    bool first = true;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line == "\r")
+        {
+            continue;
+        }
+
+        const char* text = line.c_str();
+        char* end = nullptr;
+        const long double t = std::strtold(text, &end);
+        const bool numeric = end != text && *end == ',';
+        if (!numeric)
+        {
+            // Only the first line may be a header
+            if (first)
+            {
+                first = false;
+                continue;
+            }
+            return false;
+        }
+        first = false;
+
+        text = end + 1;
+        const long double y = std::strtold(text, &end);
+        if (end == text || (!loadedTimes.empty() && T(t) <= loadedTimes.back()))
+        {
+            return false;
+        }
+        loadedTimes.push_back(T(t));
+        loadedValues.push_back(T(y));
+    }
+
+    if (loadedTimes.empty())
+    {
+        return false;
+    }
+    SetData(loadedTimes, loadedValues);
+    return true;
+}
+
+template <typename T>
+void ParameterFitter<T>::SetData(const std::vector<T>& times, const std::vector<T>& values)
+{
+    this->times = times;
+    data = values;
+}
+
+template <typename T>
+bool ParameterFitter<T>::AddParameter(const std::string& name, const T& value)
+{
+    if (std::find(names.begin(), names.end(), name) != names.end() || !solver.SetParameter(name, value))
+    {
+        return false;
+    }
+    names.push_back(name);
+    start.push_back(value);
+    return true;
+}
+
+template <typename T>
+void ParameterFitter<T>::SetFitInitialValue(bool enabled)
+{
+    fitInitialValue = enabled;
+}
+
+template <typename T>
+bool ParameterFitter<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return solver.IsExpressionValid(expression_str);
+}
+
+template <typename T>
+void ParameterFitter<T>::SetLimits(int maxIterations, const T& tolerance)
+{
+    this->maxIterations = maxIterations;
+    this->tolerance = tolerance;
+}
+
+template <typename T>
+const std::vector<T>& ParameterFitter<T>::GetTimes() const
+{
+    return times;
+}
+
+template <typename T>
+const SolverStats& ParameterFitter<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+T ParameterFitter<T>::Evaluate(const T& y0, const T& h, const T& t0, const std::string& expr, const std::vector<T>& point)
+{
+    const size_t parameters = names.size();
+    const size_t n = point.size();
+    for (size_t j = 0; j < parameters; j++)
+    {
+        solver.SetParameter(names[j], point[j]);
+    }
+    solver.SolveAt(fitInitialValue ? point[parameters] : y0, h, t0, times, expr, rows);
+    stats.steps += solver.GetStats().steps;
+    stats.evaluations += solver.GetStats().evaluations;
+
+    // Sensitivity columns follow t and y, in the order of the point
+    T cost = T(0);
+    for (size_t i = 0; i < times.size(); i++)
+    {
+        residuals[i] = rows[i][1] - data[i];
+        cost += residuals[i] * residuals[i];
+        for (size_t j = 0; j < n; j++)
+        {
+            jacobian[i * n + j] = rows[i][2 + j];
+        }
+    }
+    return cost / 2;
+}
+
+// Gaussian elimination with partial pivoting on the small n x n system
+template <typename T>
+bool ParameterFitter<T>::SolveDamped(const T& lambda)
+{
+    const size_t n = step.size();
+    for (size_t r = 0; r < n; r++)
+    {
+        for (size_t c = 0; c < n; c++)
+        {
+            system[r * n + c] = normal[r * n + c];
+        }
+        const T diagonal = normal[r * n + r];
+        system[r * n + r] += lambda * (diagonal > T(0) ? diagonal : T(1));
+        step[r] = -gradient[r];
+    }
+
+    for (size_t k = 0; k < n; k++)
+    {
+        size_t pivot = k;
+        for (size_t r = k + 1; r < n; r++)
+        {
+            if (std::fabs(system[r * n + k]) > std::fabs(system[pivot * n + k]))
+            {
+                pivot = r;
+            }
+        }
+        if (!(std::fabs(system[pivot * n + k]) > T(0)))
+        {
+            return false;
+        }
+        if (pivot != k)
+        {
+            for (size_t c = 0; c < n; c++)
+            {
+                std::swap(system[k * n + c], system[pivot * n + c]);
+            }
+            std::swap(step[k], step[pivot]);
+        }
+        for (size_t r = k + 1; r < n; r++)
+        {
+            const T factor = system[r * n + k] / system[k * n + k];
+            for (size_t c = k; c < n; c++)
+            {
+                system[r * n + c] -= factor * system[k * n + c];
+            }
+            step[r] -= factor * step[k];
+        }
+    }
+    for (size_t k = n; k-- > 0;)
+    {
+        T sum = step[k];
+        for (size_t c = k + 1; c < n; c++)
+        {
+            sum -= system[k * n + c] * step[c];
+        }
+        step[k] = sum / system[k * n + k];
+    }
+    return true;
+}
+
+template <typename T>
+FitResult<T> ParameterFitter<T>::Fit(const T& y0, const T& h, const T& t0, const std::string& expr)
+{
+    if (times.empty() || times.size() != data.size())
+    {
+        throw std::runtime_error("No data to fit");
+    }
+    if (!solver.IsExpressionValid(expr))
+    {
+        throw std::runtime_error("Invalid expression: " + expr);
+    }
+
+    TraceSpan fitSpan("fit");
+    stats = SolverStats();
+    solver.SetInitialValueSensitivity(fitInitialValue);
+
+    const size_t n = names.size() + (fitInitialValue ? 1 : 0);
+    const size_t m = times.size();
+    residuals.assign(m, T(0));
+    jacobian.assign(m * n, T(0));
+    normal.assign(n * n, T(0));
+    system.assign(n * n, T(0));
+    gradient.assign(n, T(0));
+    step.assign(n, T(0));
+
+    std::vector<T> point = start;
+    if (fitInitialValue)
+    {
+        point.push_back(y0);
+    }
+    trial.assign(n, T(0));
+
+    FitResult<T> result;
+    T cost = Evaluate(y0, h, t0, expr, point);
+    result.solves = 1;
+    T lambda = T(1e-3);
+
+    while (result.iterations < maxIterations && !result.converged)
+    {
+        result.iterations++;
+
+        // Normal equations from the Jacobian of the current point
+        for (size_t r = 0; r < n; r++)
+        {
+            T sum = T(0);
+            for (size_t i = 0; i < m; i++)
+            {
+                sum += jacobian[i * n + r] * residuals[i];
+            }
+            gradient[r] = sum;
+            for (size_t c = 0; c <= r; c++)
+            {
+                T product = T(0);
+                for (size_t i = 0; i < m; i++)
+                {
+                    product += jacobian[i * n + r] * jacobian[i * n + c];
+                }
+                normal[r * n + c] = product;
+                normal[c * n + r] = product;
+            }
+        }
+
+        // Raise the damping until a step lowers the cost; a rejected trial
+        // overwrites the residuals, but the normal equations are kept
+        bool accepted = false;
+        while (!accepted && lambda < T(1e12))
+        {
+            if (!SolveDamped(lambda))
+            {
+                lambda *= 10;
+                continue;
+            }
+            for (size_t j = 0; j < n; j++)
+            {
+                trial[j] = point[j] + step[j];
+            }
+            const T trialCost = Evaluate(y0, h, t0, expr, trial);
+            result.solves++;
+            if (trialCost < cost)
+            {
+                const T decrease = (cost - trialCost) / std::max(cost, std::numeric_limits<T>::min());
+                point.swap(trial);
+                cost = trialCost;
+                lambda = std::max(lambda / 10, T(1e-12));
+                accepted = true;
+                result.converged = decrease < tolerance;
+            }
+            else
+            {
+                lambda *= 10;
+            }
+        }
+
+        // No step lowers the cost any more, so this is a minimum to working precision
+        if (!accepted)
+        {
+            result.converged = true;
+        }
+    }
+
+    result.values.assign(point.begin(), point.begin() + names.size());
+    result.initialValue = fitInitialValue ? point[names.size()] : y0;
+    result.cost = cost;
+    return result;
+}
+
+template class ParameterFitter<float>;
+template class ParameterFitter<double>;
+template class ParameterFitter<long double>;
@@ -0,0 +1,86 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SensitivitySolver.h"
+
+// Outcome of ParameterFitter::Fit
+template <typename T>
+struct FitResult
+{
+    std::vector<T> values;
+    T initialValue = T(0);
+    T cost = T(0);
+    int iterations = 0;
+    int solves = 0;
+    bool converged = false;
+};
+
+// Least squares fit of expression parameters, and optionally y0, to measured
+// (t, y) data by Levenberg-Marquardt. The data is loaded once; every trial
+// point is one SensitivitySolver::SolveAt over the data times, which gives the
+// residuals and their exact Jacobian together from the same compiled
+// expression, and the normal equations live in workspaces sized once per fit.
+template <typename T>
+class ParameterFitter
+{
+public:
+
+    ParameterFitter();
+
+    // Reads t,y rows from a CSV file such as the solver writes, skipping a
+    // header line. Returns false if the file cannot be read, a row is not two
+    // numbers or the times are not increasing.
+    bool LoadData(const std::string& path);
+
+    void SetData(const std::vector<T>& times, const std::vector<T>& values);
+
+    // Adds a parameter to fit, starting from value. Returns false if the name
+    // is not allowed as a parameter.
+    bool AddParameter(const std::string& name, const T& value);
+
+    void SetFitInitialValue(bool enabled);
+
+    // Whether the expression compiles with the parameters added so far
+    bool IsExpressionValid(const std::string& expression_str);
+
+    // Iteration limit and the relative cost decrease below which a step ends the fit
+    void SetLimits(int maxIterations, const T& tolerance);
+
+    // Fits by integrating from (t0, y0) with fixed RK4 steps of h. Throws
+    // std::runtime_error if no data is loaded or the expression is invalid.
+    FitResult<T> Fit(const T& y0, const T& h, const T& t0, const std::string& expr);
+
+    const std::vector<T>& GetTimes() const;
+
+    const SolverStats& GetStats() const;
+
+private:
+
+    // Cost 0.5 sum r^2 at the current parameters, filling residuals and
+    // jacobian from one solve
+    T Evaluate(const T& y0, const T& h, const T& t0, const std::string& expr, const std::vector<T>& point);
+
+    // Solves (J^T J + lambda diag(J^T J)) step = -J^T r; false if singular
+    bool SolveDamped(const T& lambda);
+
+    SensitivitySolver<T> solver;
+    std::vector<std::string> names;
+    std::vector<T> start;
+    bool fitInitialValue = false;
+    int maxIterations = 100;
+    T tolerance = T(1e-10);
+
+    std::vector<T> times;
+    std::vector<T> data;
+
+    // Workspaces, sized at the start of each fit and reused by every iteration
+    std::vector<std::vector<T>> rows;
+    std::vector<T> residuals;
+    std::vector<T> jacobian;
+    std::vector<T> normal;
+    std::vector<T> gradient;
+    std::vector<T> system;
+    std::vector<T> step;
+    std::vector<T> trial;
+    SolverStats stats;
+};
@@ -0,0 +1,195 @@
+#include "PararealSolver.h"
+#include "ButcherTableau.h"
+#include "ExplicitRungeKutta.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+template <typename T>
+PararealSolver<T>::PararealSolver(int threads) : pool(threads), tolerance(T(1000) * std::numeric_limits<T>::epsilon())
+{
+    for (int worker = 0; worker < pool.GetThreadCount(); worker++)
+    {
+        expressions.push_back(std::make_unique<OdeExpression<T>>());
+    }
+}
+
+template <typename T>
+bool PararealSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expressions[0]->Compile(expression_str);
+}
+
+template <typename T>
+void PararealSolver<T>::SetSlices(int slices)
+{
+    this->slices = slices;
+}
+
+template <typename T>
+void PararealSolver<T>::SetCoarseRatio(int ratio)
+{
+    coarseRatio = std::max(1, ratio);
+}
+
+template <typename T>
+void PararealSolver<T>::SetTolerance(const T& tolerance)
+{
+    this->tolerance = tolerance;
+}
+
+template <typename T>
+const SolverStats& PararealSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+const PararealStats<T>& PararealSolver<T>::GetPararealStats() const
+{
+    return pararealStats;
+}
+
+template <typename T>
+T PararealSolver<T>::Fine(int worker, const T& t0, const T& h, int first, int last, const T& y, std::vector<std::vector<T>>& out, long long& evaluations)
+{
+    OdeExpression<T>& expression = *expressions[worker];
+    auto f = [&](const T& time, const T& state) { evaluations++; return expression.Evaluate(time, state); };
+
+    T w = y;
+    T kLast, error;
+    for (int index = first; index < last; index++)
+    {
+        const T i = t0 + index * h;
+        out[index] = { i, w };
+        w = ExplicitRungeKutta<Rk4Tableau, T>::Step(f, i, w, h, f(i, w), kLast, error);
+    }
+    return w;
+}
+
+template <typename T>
+T PararealSolver<T>::Coarse(const T& from, const T& to, const T& h, const T& y, long long& evaluations)
+{
+    OdeExpression<T>& expression = *expressions[0];
+    auto f = [&](const T& time, const T& state) { evaluations++; return expression.Evaluate(time, state); };
+
+    const int steps = std::max(1, int(std::ceil((to - from) / (coarseRatio * h))));
+    const T step = (to - from) / steps;
+    T w = y;
+    T kLast, error;
+    for (int index = 0; index < steps; index++)
+    {
+        const T i = from + index * step;
+        w = ExplicitRungeKutta<Rk4Tableau, T>::Step(f, i, w, step, f(i, w), kLast, error);
+    }
+    return w;
+}
+
+template <typename T>
+void PararealSolver<T>::Solve(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    for (std::unique_ptr<OdeExpression<T>>& expression : expressions)
+    {
+        if (!expression->Compile(expr))
+        {
+            throw std::runtime_error("Invalid expression: " + expr);
+        }
+    }
+    stats = SolverStats();
+    pararealStats = PararealStats<T>();
+
+    TraceSpan solveSpan("solve");
+
+    const int steps = int(std::ceil((t - t0) / h));
+    out.assign(steps + 1, std::vector<T>(2));
+
+    // Slice p covers fine steps boundary[p] .. boundary[p + 1]
+    const int count = std::max(1, std::min(steps, slices > 0 ? slices : pool.GetThreadCount()));
+    std::vector<int> boundary(count + 1);
+    for (int p = 0; p <= count; p++)
+    {
+        boundary[p] = int((long long)steps * p / count);
+    }
+    auto timeAt = [&](int p) { return t0 + boundary[p] * h; };
+
+    // Start values U, coarse results G and fine results F per slice
+    std::vector<T> start(count + 1), coarse(count), fine(count);
+    std::vector<long long> sliceEvaluations(count);
+    long long coarseEvaluations = 0;
+
+    {
+        TraceSpan span("coarse");
+        start[0] = y0;
+        for (int p = 0; p < count; p++)
+        {
+            coarse[p] = Coarse(timeAt(p), timeAt(p + 1), h, start[p], coarseEvaluations);
+            start[p + 1] = coarse[p];
+        }
+    }
+    pararealStats.criticalPathEvaluations = coarseEvaluations;
+
+    int iteration = 0;
+    while (iteration < count)
+    {
+        // Slices before the iteration number start from exact values, so
+        // their fine rows from the previous iteration are already final
+        const int firstOpen = iteration;
+        iteration++;
+
+        std::fill(sliceEvaluations.begin(), sliceEvaluations.end(), 0);
+        pool.ParallelFor(count - firstOpen, [&](int worker, int index)
+            {
+                const int p = firstOpen + index;
+                fine[p] = Fine(worker, t0, h, boundary[p], boundary[p + 1], start[p], out, sliceEvaluations[p]);
+            });
+
+        long long longestSlice = 0;
+        for (int p = firstOpen; p < count; p++)
+        {
+            pararealStats.fineEvaluations += sliceEvaluations[p];
+            longestSlice = std::max(longestSlice, sliceEvaluations[p]);
+        }
+
+        // Serial correction sweep
+        TraceSpan span("coarse");
+        const long long coarseBefore = coarseEvaluations;
+        T correction = T(0);
+        for (int p = firstOpen; p < count; p++)
+        {
+            const T predicted = p == firstOpen ? coarse[p] : Coarse(timeAt(p), timeAt(p + 1), h, start[p], coarseEvaluations);
+            const T corrected = p == firstOpen ? fine[p] : predicted + fine[p] - coarse[p];
+            coarse[p] = predicted;
+            correction = std::max(correction, std::fabs(corrected - start[p + 1]) / (T(1) + std::fabs(corrected)));
+            start[p + 1] = corrected;
+        }
+        pararealStats.criticalPathEvaluations += longestSlice + coarseEvaluations - coarseBefore;
+        pararealStats.correction = correction;
+
+        if (correction <= tolerance)
+        {
+            pararealStats.converged = true;
+            break;
+        }
+    }
+
+    // The last slice's fine result ends the trajectory the rows were written from
+    out[steps] = { t0 + steps * h, fine[count - 1] };
+
+    pararealStats.slices = count;
+    pararealStats.iterations = iteration;
+    pararealStats.coarseEvaluations = coarseEvaluations;
+    pararealStats.converged = pararealStats.converged || iteration == count;
+    stats.steps = steps;
+    stats.evaluations = pararealStats.fineEvaluations + coarseEvaluations;
+}
+
+template class PararealSolver<float>;
+template class PararealSolver<double>;
+template class PararealSolver<long double>;
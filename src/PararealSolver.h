@@ -0,0 +1,75 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "OdeExpression.h"
+#include "SolverStats.h"
+#include "ThreadPool.h"
+
+// Iteration counts and costs of the last PararealSolver::Solve. The critical
+// path counts the evaluations that cannot overlap: the serial coarse sweeps
+// plus the longest fine slice of each iteration, so serial evaluations over
+// it is the speedup the method allows with one core per slice.
+template <typename T>
+struct PararealStats
+{
+    int slices = 0;
+    int iterations = 0;
+    bool converged = false;
+    T correction = T(0);
+    long long fineEvaluations = 0;
+    long long coarseEvaluations = 0;
+    long long criticalPathEvaluations = 0;
+};
+
+// Parallel-in-time RK4 by Parareal. [t0, t] is cut into slices, one per
+// thread by default. A coarse RK4 with steps CoarseRatio times larger than h
+// sweeps serially across the slices, the fine fixed-step RK4 of
+// RungeKuttaSolver runs on all slices at once from the current slice start
+// values, and the start values are corrected by U = G(new) + F(old) - G(old)
+// until they stop changing. After k iterations the first k slices are exact,
+// so the result matches the serial fine solution whenever it converges.
+template <typename T>
+class PararealSolver
+{
+public:
+
+    // 0 threads uses one per hardware thread
+    explicit PararealSolver(int threads = 0);
+
+    // Same output layout as RungeKuttaSolver::Solve: ceil((t - t0) / h) + 1 points
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    // 0 uses one slice per thread
+    void SetSlices(int slices);
+
+    // Fine steps per coarse step
+    void SetCoarseRatio(int ratio);
+
+    // Largest change of a slice start value, relative to 1 + |y|, that counts as converged
+    void SetTolerance(const T& tolerance);
+
+    const SolverStats& GetStats() const;
+
+    const PararealStats<T>& GetPararealStats() const;
+
+private:
+
+    // Fixed-step RK4 from (from, y) over steps of h; writes out rows first .. last - 1
+    T Fine(int worker, const T& t0, const T& h, int first, int last, const T& y, std::vector<std::vector<T>>& out, long long& evaluations);
+
+    // RK4 over [from, to] with steps about CoarseRatio h long
+    T Coarse(const T& from, const T& to, const T& h, const T& y, long long& evaluations);
+
+    ThreadPool pool;
+    std::vector<std::unique_ptr<OdeExpression<T>>> expressions;
+
+    int slices = 0;
+    int coarseRatio = 20;
+    T tolerance;
+    SolverStats stats;
+    PararealStats<T> pararealStats;
+};
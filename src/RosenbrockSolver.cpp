@@ -0,0 +1,133 @@
+#include "RosenbrockSolver.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+template <typename T>
+RosenbrockSolver<T>::RosenbrockSolver()
+{
+}
+
+template <typename T>
+bool RosenbrockSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str);
+}
+
+template <typename T>
+void RosenbrockSolver<T>::SetTolerances(const T& relative, const T& absolute)
+{
+    relativeTolerance = relative;
+    absoluteTolerance = absolute;
+}
+
+template <typename T>
+const SolverStats& RosenbrockSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+void RosenbrockSolver<T>::Solve(const T& y0, const T& h0, const T& t, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    if (!expression.Compile(expr))
+    {
+        throw std::runtime_error("Invalid expression: " + expr);
+    }
+    stats = SolverStats();
+
+    TraceSpan solveSpan("solve");
+
+    const T d = RosenbrockW<T>::Gamma();
+    const T minStep = 16 * std::numeric_limits<T>::epsilon();
+
+    auto f = [this](const T& time, const T& y) { return dydt(time, y); };
+    T w = y0;
+    T i = t0;
+    T h = std::min(h0, t - t0);
+    T f0 = dydt(i, w);
+
+    // df/dy and the "factorization" 1 / (1 - h d J) of the scalar iteration
+    // matrix, which is only redone when h or the Jacobian changes
+    T jacobian = T(0), inverse = T(0), factoredStep = T(0);
+    bool jacobianCurrent = false;
+    bool rejected = false;
+    int jacobianAge = MaxJacobianAge;
+
+    out.clear();
+    out.push_back({ i, w });
+
+    while (i < t)
+    {
+        if (h <= minStep * std::max(T(1), std::fabs(i)))
+        {
+            throw std::runtime_error("Step size underflow in Rosenbrock integration");
+        }
+
+        if (jacobianAge >= MaxJacobianAge)
+        {
+            jacobian = expression.PartialY(i, w);
+            stats.jacobianEvaluations++;
+            jacobianCurrent = true;
+            jacobianAge = 0;
+            factoredStep = T(0);
+        }
+
+        const T last = i + h >= t ? t : i + h;
+        const T step = last - i;
+
+        const T timeDerivative = RosenbrockW<T>::TimeDerivative(f, i, w, step, f0);
+        if (step != factoredStep)
+        {
+            inverse = T(1) / (T(1) - step * d * jacobian);
+            factoredStep = step;
+            stats.factorizations++;
+        }
+
+        T f2, error;
+        const T next = RosenbrockW<T>::Step(f, i, w, step, f0, timeDerivative, inverse, f2, error);
+        const T scale = absoluteTolerance + relativeTolerance * std::max(std::fabs(w), std::fabs(next));
+        const T ratio = error / scale;
+        const T factor = ratio == 0 ? T(5) : std::min(T(5), std::max(T(0.2), T(0.9) * std::pow(ratio, -T(1) / 3)));
+
+        if (ratio <= 1)
+        {
+            i = last;
+            w = next;
+            f0 = f2;
+            out.push_back({ i, w });
+            stats.steps++;
+            jacobianAge++;
+            jacobianCurrent = false;
+
+            // Do not grow the step straight after a rejection
+            h = step * (rejected ? std::min(T(1), factor) : factor);
+            rejected = false;
+        }
+        else
+        {
+            stats.rejectedSteps++;
+            rejected = true;
+            if (jacobianCurrent)
+            {
+                h = step * std::min(T(1), factor);
+            }
+            else
+            {
+                // Retry with a fresh Jacobian before giving up step size
+                jacobianAge = MaxJacobianAge;
+            }
+        }
+    }
+}
+
+template class RosenbrockSolver<float>;
+template class RosenbrockSolver<double>;
+template class RosenbrockSolver<long double>;
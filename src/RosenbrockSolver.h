@@ -0,0 +1,87 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include "OdeExpression.h"
+#include "SolverStats.h"
+
+// One step of the ode23s Rosenbrock-W pair, shared by the solvers that use it
+template <typename T>
+struct RosenbrockW
+{
+    // d in the iteration matrix 1 - h d J
+    static T Gamma()
+    {
+        return T(1) / (T(2) + std::sqrt(T(2)));
+    }
+
+    // One sided difference for df/dt at (t, y), given f0 = f(t, y). Unlike
+    // df/dy, an outdated df/dt costs accuracy on forced problems, so callers
+    // refresh it every step.
+    template <typename F>
+    static T TimeDerivative(F& f, const T& t, const T& y, const T& h, const T& f0)
+    {
+        const T delta = std::sqrt(std::numeric_limits<T>::epsilon()) * std::max(std::fabs(t), std::fabs(h));
+        return (f(t + delta, y) - f0) / delta;
+    }
+
+    // Advances y from t by h. f0 is f(t, y), dfdt approximates df/dt and
+    // inverse is 1 / (1 - h d J). f2 receives f(t + h, y_n+1) and error the
+    // embedded error estimate.
+    template <typename F>
+    static T Step(F& f, const T& t, const T& y, const T& h, const T& f0, const T& dfdt, const T& inverse, T& f2, T& error)
+    {
+        const T d = Gamma();
+        const T e32 = T(6) + std::sqrt(T(2));
+
+        const T k1 = inverse * (f0 + h * d * dfdt);
+        const T f1 = f(t + h / 2, y + h / 2 * k1);
+        const T k2 = inverse * (f1 - k1) + k1;
+        const T next = y + h * k2;
+        f2 = f(t + h, next);
+        const T k3 = inverse * (f2 - e32 * (k2 - f1) - 2 * (k1 - f0) + h * d * dfdt);
+
+        error = h / 6 * std::fabs(k1 - 2 * k2 + k3);
+        return next;
+    }
+};
+
+// Linearly implicit solver for stiff problems: the second order Rosenbrock-W
+// formula of Shampine and Reichelt (MATLAB's ode23s) with an embedded third
+// order error estimate and adaptive steps. Being a W-method it keeps its order
+// with an outdated df/dy, so the Jacobian is reused across steps and only
+// re-evaluated after a rejected step or every MaxJacobianAge accepted steps.
+template <typename T>
+class RosenbrockSolver
+{
+public:
+
+    RosenbrockSolver();
+
+    // h is the initial step; the output holds every accepted step
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    void SetTolerances(const T& relative, const T& absolute);
+
+    const SolverStats& GetStats() const;
+
+private:
+
+    static const int MaxJacobianAge = 20;
+
+    T dydt(const T& t, const T& y)
+    {
+        stats.evaluations++;
+        return expression.Evaluate(t, y);
+    }
+
+    OdeExpression<T> expression;
+    T relativeTolerance = T(1e-6);
+    T absoluteTolerance = T(1e-6);
+    SolverStats stats;
+};
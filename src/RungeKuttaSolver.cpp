@@ -1,7 +1,30 @@
 #include "RungeKuttaSolver.h"
+#include "AdamsBashforthMoultonSolver.h"
+#include "AutoSwitchingSolver.h"
+#include "Benchmarks.h"
+#include "BdfSolver.h"
+#include "BulirschStoerSolver.h"
+#include "DenseOutput.h"
+#include "ExplicitRungeKutta.h"
+#include "MixedPrecisionSolver.h"
+#include "ParameterFitter.h"
+#include "PararealSolver.h"
+#include "RosenbrockSolver.h"
+#include "SlidingWindow.h"
+#include "TrajectorySummary.h"
+#include "TaylorSolver.h"
+#include "Tracer.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 
 // Trim from the start (in place)
 void ltrim(std::string& s)
@@ -47,48 +70,656 @@ std::string trim_copy(std::string s)
     return s;
 }
 
-RungeKuttaSolver::RungeKuttaSolver()
+template <typename T>
+RungeKuttaSolver<T>::RungeKuttaSolver()
 {
 }
 
+// Compiles the expression unless it is the one already compiled
+template <typename T>
+void RungeKuttaSolver<T>::CompileExpression(const std::string& expression_string)
+{
+    if (!expression.Compile(expression_string))
+    {
+        throw std::runtime_error("Invalid expression: " + expression_string);
+    }
+}
+
+template <typename T>
+bool RungeKuttaSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str);
+}
+
+template <typename T>
+bool RungeKuttaSolver<T>::SetParameter(const std::string& name, const T& value)
+{
+    return expression.SetParameter(name, value);
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::SetMethod(Method method)
+{
+    this->method = method;
+}
+
+template <typename T>
+Method RungeKuttaSolver<T>::GetMethod() const
+{
+    return method;
+}
+
+// A positive tolerance makes embedded pairs adapt the step size; h is then the initial step
+template <typename T>
+void RungeKuttaSolver<T>::SetTolerance(const T& tolerance)
+{
+    this->tolerance = tolerance;
+}
+
+template <typename T>
+bool RungeKuttaSolver<T>::AddEvent(const std::string& expression, EventAction action)
+{
+    return events.Add(expression, action);
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::ClearEvents()
+{
+    events.Clear();
+}
+
+template <typename T>
+const std::vector<EventRecord<T>>& RungeKuttaSolver<T>::GetEvents() const
+{
+    return events.GetRecords();
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::SetSteadyState(const SteadyStateOptions<T>& options)
+{
+    steadyState.Configure(options);
+}
+
+template <typename T>
+const SteadyStateStats<T>& RungeKuttaSolver<T>::GetSteadyStateStats() const
+{
+    return steadyStats;
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::RecordSteadyState(const T& time, const T& t, long long stepsSkipped)
+{
+    steadyStats.reached = true;
+    steadyStats.time = time;
+    steadyStats.skippedTime = t - time;
+    steadyStats.stepsSkipped = stepsSkipped;
+}
+
+template <typename T>
+const SolverStats& RungeKuttaSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+// Checks an accepted step from (t0, y0) to (t1, y1) for events. Returns true
+// if a terminal event fired, with the event point in t1 and y1. The slope at
+// the step end for the interpolant is only evaluated when something crossed.
+template <typename T>
+template <typename Tableau>
+bool RungeKuttaSolver<T>::StopAtEvent(const T& t0, const T& y0, const T& f0, const T& kLast, T& t1, T& y1)
+{
+    if (events.IsEmpty() || !events.Crossed(t1, y1))
+    {
+        return false;
+    }
+    const T f1 = Tableau::FirstSameAsLast ? kLast : dydt(t1, y1);
+    return events.Locate({ t0, y0, f0, t1, y1, f1 }, t1, y1);
+}
+
 // Solves the expression as a string using exprtk. Out vector is set to the result
-void RungeKuttaSolver::Solve(const float& y0, const float& h, const float& t, const float& t0, const std::string& expr, std::vector<std::vector<float>>& out)
+template <typename T>
+void RungeKuttaSolver<T>::Solve(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
 {
     if (t0 >= t)
     {
         return;
     }
 
-    // Set size of output vector
+    CompileExpression(expr);
+    stats = SolverStats();
+    events.Start(t0, y0);
+    steadyState.Start();
+    steadyStats = SteadyStateStats<T>();
+
+    SolverCheckpoint<T> start;
+    start.expression = expr;
+    start.parameters = expression.GetParameters();
+    start.method = method;
+    start.tolerance = tolerance;
+    start.t0 = t0;
+    start.t = t;
+    start.h = h;
+    start.time = t0;
+    start.y = y0;
+    start.step = h;
+    Integrate(start, out);
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::Resume(const std::string& path, std::vector<std::vector<T>>& out)
+{
+    SolverCheckpoint<T> start;
+    if (!LoadCheckpoint(path, start))
+    {
+        throw std::runtime_error("Could not read checkpoint " + path);
+    }
+
+    // Other parameter values would silently continue a different ODE
+    for (const std::pair<std::string, T>& parameter : start.parameters)
+    {
+        T value;
+        if (!expression.GetParameter(parameter.first, value) || value != parameter.second)
+        {
+            std::ostringstream message;
+            message << "Checkpoint " << path << " was saved with " << parameter.first << " = " << parameter.second;
+            throw std::runtime_error(message.str());
+        }
+    }
+
+    CompileExpression(start.expression);
+    method = start.method;
+    tolerance = start.tolerance;
+    stats = start.stats;
+    events.Start(start.time, start.y);
+    steadyState.Start();
+    steadyStats = SteadyStateStats<T>();
+    Integrate(start, out);
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::Continue(const T& t, std::vector<std::vector<T>>& out)
+{
+    if (!continuable)
+    {
+        throw std::runtime_error("Nothing to continue: the last run failed or stopped at an event or steady state");
+    }
+    if (t <= progress.time)
+    {
+        out.clear();
+        return;
+    }
+
+    // The expression compiled for the last run is still current, and the
+    // method and tolerance stay as it had them
+    SolverCheckpoint<T> start = progress;
+    start.t = t;
+    method = start.method;
+    tolerance = start.tolerance;
+    events.Start(start.time, start.y);
+    steadyState.Start();
+    steadyStats = SteadyStateStats<T>();
+    Integrate(start, out);
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::SetCheckpoint(const std::string& path, long long interval, RowSink sink)
+{
+    checkpointPath = path;
+    checkpointInterval = std::max(1LL, interval);
+    this->sink = sink;
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::SetStreaming(size_t rows, RowSink sink)
+{
+    streamRows = rows;
+    this->sink = sink;
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::Integrate(const SolverCheckpoint<T>& start, std::vector<std::vector<T>>& out)
+{
+    progress = start;
+    delivered = start.rows;
+    outputOffset = start.rows;
+    continuable = false;
+
+    TraceSpan solveSpan("solve");
+    VisitTableau(method, [&](auto tableau)
+        {
+            typedef decltype(tableau) Tableau;
+            if (tolerance <= 0)
+            {
+                IntegrateFixed<Tableau>(start, out);
+            }
+            else if constexpr (Tableau::Embedded)
+            {
+                IntegrateAdaptive<Tableau>(start, out);
+            }
+            else
+            {
+                throw std::runtime_error(std::string("Method ") + Tableau::Name + " has no error estimate for adaptive stepping");
+            }
+        });
+
+    // The run is complete, so the rest goes to the sink and there is nothing left to resume
+    if (streamRows > 0 || !checkpointPath.empty())
+    {
+        Deliver(out, out.size());
+    }
+    if (!checkpointPath.empty())
+    {
+        std::remove(checkpointPath.c_str());
+    }
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::Deliver(const std::vector<std::vector<T>>& out, size_t end)
+{
+    const size_t first = size_t(delivered - outputOffset);
+    if (sink && first < end)
+    {
+        sink(out, first, end);
+    }
+    delivered = outputOffset + (long long)end;
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::SaveProgress(long long index, const T& time, const T& y, const T& step, const T& slope, long long rows,
+    const std::vector<std::vector<T>>& out)
+{
+    Deliver(out, size_t(rows - outputOffset));
+    Record(index, time, y, step, slope, rows);
+    SaveCheckpoint(checkpointPath, progress);
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::Record(long long index, const T& time, const T& y, const T& step, const T& slope, long long rows)
+{
+    progress.index = index;
+    progress.time = time;
+    progress.y = y;
+    progress.step = step;
+    progress.slope = slope;
+    progress.rows = rows;
+    progress.stats = stats;
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::SolveSweep(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr,
+    const std::string& parameter, const std::vector<T>& values, std::vector<std::vector<std::vector<T>>>& out)
+{
+    out.resize(values.size());
+    SolverStats total;
+    for (size_t run = 0; run < values.size(); run++)
+    {
+        if (!SetParameter(parameter, values[run]))
+        {
+            throw std::runtime_error("Invalid parameter name: " + parameter);
+        }
+        Solve(y0, h, t, t0, expr, out[run]);
+        total.steps += stats.steps;
+        total.rejectedSteps += stats.rejectedSteps;
+        total.evaluations += stats.evaluations;
+    }
+    stats = total;
+}
+
+// Fixed steps of size h; the output holds ceil((t - t0) / h) + 1 points, less
+// those a resumed run handed out before its checkpoint
+template <typename T>
+template <typename Tableau>
+void RungeKuttaSolver<T>::IntegrateFixed(const SolverCheckpoint<T>& start, std::vector<std::vector<T>>& out)
+{
+    const T t0 = start.t0;
+    const T t = start.t;
+    const T h = start.h;
+
+    // Set size of output vector; streaming keeps one batch of rows and reuses it
     const int x = int(std::ceil((t - t0) / h)) + 1;
-    out.resize(x, std::vector<float>(2));
+    const long long remaining = x - start.rows;
+    out.assign(size_t(streamRows > 0 ? std::min<long long>(remaining, streamRows) : remaining), std::vector<T>(2));
+
+    // Row k of the whole run is out[k - outputOffset]; a full batch is handed
+    // to the sink before the next row overwrites it
+    auto row = [&](int k, const T& time, const T& y)
+    {
+        if (k < outputOffset)
+        {
+            return;
+        }
+        if (k - outputOffset == (long long)out.size())
+        {
+            Deliver(out, out.size());
+            outputOffset += out.size();
+        }
+        out[k - outputOffset] = { time, y };
+    };
+
+    auto f = [this](const T& time, const T& y) { return dydt(time, y); };
+    T w = start.y;
+    T i = start.time;
+    T k0 = T(0), kLast = start.slope, error;
+    int index = int(start.index);
+    const int steps = x - 1;
+    const bool checkpointing = !checkpointPath.empty();
+
+    while (index < steps)
+    {
+        // Steps are traced in batches so the trace stays small on long runs
+        TraceSpan batchSpan("stages");
+        for (int batch = 0; batch < TraceBatchSize && index < steps; batch++)
+        {
+            row(index, i, w);
+
+            if constexpr (Tableau::Embedded && Tableau::FirstSameAsLast)
+            {
+                k0 = index == 0 ? dydt(i, w) : kLast;
+            }
+            else
+            {
+                k0 = dydt(i, w);
+            }
+            // Time is recomputed from the step index rather than accumulated, so
+            // rounding in h does not build up over long runs
+            T end = t0 + (index + 1) * h;
+            T next = ExplicitRungeKutta<Tableau, T>::Step(f, i, w, h, k0, kLast, error);
+            if (StopAtEvent<Tableau>(i, w, k0, kLast, end, next))
+            {
+                row(index + 1, end, next);
+                out.resize(index + 2 - outputOffset);
+                stats.steps = index + 1;
+                return;
+            }
 
-    float w = y0;
-    float k1, k2, k3, k4;
-    float i = t0;
-    int index = 0;
+            const T change = next - w;
+            w = next;
+            index++;
+            i = end;
 
+            // Once settled, the remaining rows are filled without evaluations or dropped
+            if (steadyState.Settled(k0, change))
+            {
+                row(index, i, w);
+                RecordSteadyState(i, t, steps - index);
+                if (steadyState.GetOptions().output == SteadyStateOutput::Fill)
+                {
+                    for (int k = index + 1; k <= steps; k++)
+                    {
+                        row(k, t0 + k * h, w);
+                    }
+                    out.resize(steps + 1 - outputOffset);
+                }
+                else
+                {
+                    out.resize(index + 1 - outputOffset);
+                }
+                stats.steps = index;
+                return;
+            }
+
+            if (checkpointing && index % checkpointInterval == 0 && index < steps)
+            {
+                row(index, i, w);
+                stats.steps = index;
+                SaveProgress(index, i, w, h, kLast, index + 1, out);
+            }
+        }
+    }
+
+    row(index, i, w);
+    out.resize(index + 1 - outputOffset);
+    stats.steps = steps;
+    Record(index, i, w, h, kLast, index + 1);
+    continuable = true;
+}
+
+// Error-controlled steps with an embedded pair; the output holds every accepted step
+template <typename T>
+template <typename Tableau>
+void RungeKuttaSolver<T>::IntegrateAdaptive(const SolverCheckpoint<T>& start, std::vector<std::vector<T>>& out)
+{
+    const T t = start.t;
+    const T exponent = T(1) / T(std::min(Tableau::Order, Tableau::EmbeddedOrder) + 1);
+    const T minStep = 16 * std::numeric_limits<T>::epsilon();
+
+    auto f = [this](const T& time, const T& y) { return dydt(time, y); };
+    T w = start.y;
+    T i = start.time;
+    const bool resumed = start.index > 0;
+    T h = resumed ? start.step : std::min(start.h, t - start.t0);
+    T k0 = resumed ? start.slope : dydt(i, w), kLast, error;
+    const bool checkpointing = !checkpointPath.empty();
+
+    // A resumed run handed out the row at its checkpoint already
+    out.clear();
+    if (!resumed)
+    {
+        out.push_back({ i, w });
+    }
+
+    // Streaming hands out a full batch and starts the next one empty
+    auto flush = [&]()
+    {
+        if (streamRows > 0 && out.size() >= streamRows)
+        {
+            Deliver(out, out.size());
+            outputOffset += out.size();
+            out.clear();
+        }
+    };
+
+    TraceSpan batchSpan("stages");
     while (i < t)
     {
-        out[index] = { i, w };
+        if (h <= minStep * std::max(T(1), std::fabs(i)))
+        {
+            throw std::runtime_error("Step size underflow in adaptive integration");
+        }
 
-        k1 = h * dydt<float>(i, w, expr);
-        k2 = h * dydt<float>(i + h/2, w + k1/2, expr);
-        k3 = h * dydt<float>(i + h/2, w + k2/2, expr);
-        k4 = h * dydt<float>(i + h, w + k3, expr);
+        const T last = i + h >= t ? t : i + h;
+        const T step = last - i;
+        const T next = ExplicitRungeKutta<Tableau, T>::Step(f, i, w, step, k0, kLast, error);
+        const T scale = tolerance * (T(1) + std::max(std::fabs(w), std::fabs(next)));
+        const T ratio = std::fabs(error) / scale;
 
-        w = w + (k1 + k2 + k3 + k4) / 6;
+        // Standard controller: aim for ratio 1 with a safety factor, limiting the change per step
+        const T factor = ratio == 0 ? T(5) : std::min(T(5), std::max(T(0.2), T(0.9) * std::pow(ratio, -exponent)));
+        if (ratio <= 1)
+        {
+            flush();
+            T end = last, stop = next;
+            if (StopAtEvent<Tableau>(i, w, k0, kLast, end, stop))
+            {
+                out.push_back({ end, stop });
+                stats.steps++;
+                return;
+            }
 
-        index++;
-        i += h;
+            const T slope = k0;
+            const T change = next - w;
+            i = last;
+            w = next;
+            k0 = Tableau::FirstSameAsLast ? kLast : dydt(i, w);
+            out.push_back({ i, w });
+            stats.steps++;
+            h = step * factor;
+
+            if (steadyState.Settled(slope, change))
+            {
+                RecordSteadyState(i, t, (long long)std::ceil((t - i) / step));
+                if (steadyState.GetOptions().output == SteadyStateOutput::Fill && i < t)
+                {
+                    out.push_back({ t, w });
+                }
+                return;
+            }
+
+            if (checkpointing && stats.steps % checkpointInterval == 0 && i < t)
+            {
+                SaveProgress(stats.steps, i, w, h, k0, stats.steps + 1, out);
+            }
+        }
+        else
+        {
+            stats.rejectedSteps++;
+            h = step * std::min(T(1), factor);
+        }
+    }
+
+    Record(stats.steps, i, w, h, k0, stats.steps + 1);
+    continuable = true;
+}
+
+template <typename T>
+void RungeKuttaSolver<T>::SolveOnGrid(const T& y0, const T& h, const std::vector<T>& grid, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (grid.empty())
+    {
+        out.clear();
+        return;
     }
+    if (!std::is_sorted(grid.begin(), grid.end()))
+    {
+        throw std::runtime_error("Output grid must be in increasing order");
+    }
+
+    CompileExpression(expr);
+    stats = SolverStats();
+    continuable = false;
+    events.Start(grid.front(), y0);
+    steadyState.Start();
+    steadyStats = SteadyStateStats<T>();
+
+    TraceSpan solveSpan("solve");
+    VisitTableau(method, [&](auto tableau)
+        {
+            typedef decltype(tableau) Tableau;
+            if (tolerance > 0 && !Tableau::Embedded)
+            {
+                throw std::runtime_error(std::string("Method ") + Tableau::Name + " has no error estimate for adaptive stepping");
+            }
+            IntegrateDense<Tableau>(y0, h, grid, out);
+        });
+}
+
+// Fixed or error-controlled steps as in Solve, with the output buffer sized by
+// the grid and filled by Hermite interpolation as each step passes grid points
+template <typename T>
+template <typename Tableau>
+void RungeKuttaSolver<T>::IntegrateDense(const T& y0, const T& h0, const std::vector<T>& grid, std::vector<std::vector<T>>& out)
+{
+    const T t0 = grid.front();
+    const T t = grid.back();
+    const bool adaptive = tolerance > 0;
+    T exponent = T(0);
+    if constexpr (Tableau::Embedded)
+    {
+        exponent = T(1) / T(std::min(Tableau::Order, Tableau::EmbeddedOrder) + 1);
+    }
+    const T minStep = 16 * std::numeric_limits<T>::epsilon();
+
+    out.assign(grid.size(), std::vector<T>(2));
+
+    auto f = [this](const T& time, const T& y) { return dydt(time, y); };
+    T w = y0;
+    T i = t0;
+    T h = adaptive ? std::min(h0, t - t0) : h0;
+    T k0 = dydt(i, w), kLast, error;
+    long index = 0;
+
+    size_t point = 0;
+    for (; point < grid.size() && grid[point] <= i; point++)
+    {
+        out[point] = { grid[point], w };
+    }
+
+    TraceSpan batchSpan("stages");
+    while (point < grid.size())
+    {
+        if (adaptive && h <= minStep * std::max(T(1), std::fabs(i)))
+        {
+            throw std::runtime_error("Step size underflow in adaptive integration");
+        }
+
+        // Fixed step times come from the step index, as in IntegrateFixed
+        const T last = adaptive ? (i + h >= t ? t : i + h) : std::min(t, t0 + (index + 1) * h);
+        const T step = last - i;
+        const T next = ExplicitRungeKutta<Tableau, T>::Step(f, i, w, step, k0, kLast, error);
+
+        if (adaptive)
+        {
+            const T scale = tolerance * (T(1) + std::max(std::fabs(w), std::fabs(next)));
+            const T ratio = std::fabs(error) / scale;
+            const T factor = ratio == 0 ? T(5) : std::min(T(5), std::max(T(0.2), T(0.9) * std::pow(ratio, -exponent)));
+            if (ratio > 1)
+            {
+                stats.rejectedSteps++;
+                h = step * std::min(T(1), factor);
+                continue;
+            }
+            h = step * factor;
+        }
+
+        // The slope at the end of the step is the next step's first stage
+        const T k1 = Tableau::FirstSameAsLast ? kLast : dydt(last, next);
+        const HermiteSegment<T> segment = { i, w, k0, last, next, k1 };
+
+        // A terminal event ends the output with a row at the event
+        T eventTime, eventY;
+        if (!events.IsEmpty() && events.Crossed(last, next) && events.Locate(segment, eventTime, eventY))
+        {
+            for (; point < grid.size() && grid[point] < eventTime; point++)
+            {
+                out[point] = { grid[point], segment.Value(grid[point]) };
+            }
+            out.resize(point);
+            out.push_back({ eventTime, eventY });
+            stats.steps++;
+            return;
+        }
+
+        for (; point < grid.size() && grid[point] <= last; point++)
+        {
+            out[point] = { grid[point], grid[point] == last ? next : segment.Value(grid[point]) };
+        }
+
+        const T slope = k0;
+        const T change = next - w;
+        i = last;
+        w = next;
+        k0 = k1;
+        index++;
+        stats.steps++;
 
+        if (steadyState.Settled(slope, change))
+        {
+            RecordSteadyState(i, t, (long long)std::ceil((t - i) / step));
+            if (steadyState.GetOptions().output == SteadyStateOutput::Fill)
+            {
+                for (; point < grid.size(); point++)
+                {
+                    out[point] = { grid[point], w };
+                }
+            }
+            else
+            {
+                out.resize(point);
+            }
+            return;
+        }
+    }
 }
 
-// Re-prompts with given message for input until a valid float is provided
-const float GetValidFloatInput(const std::string msg)
+template class RungeKuttaSolver<float>;
+template class RungeKuttaSolver<double>;
+template class RungeKuttaSolver<long double>;
+
+// Re-prompts with given message for input until a valid number is provided
+template <typename T>
+const T GetValidInput(const std::string msg)
 {
-    float num;
+    T num;
     while (true)
     {
         std::cout << msg << std::endl;
@@ -109,8 +740,10 @@ const float GetValidFloatInput(const std::string msg)
 }
 
 // Prints dataset to csv file
-void Print(const std::vector<std::vector<float>> dataset)
+template <typename T>
+void Print(const std::vector<std::vector<T>>& dataset)
 {
+    TraceSpan span("write");
     std::ofstream outFile("solution.csv");
 
     // Check if the file is open.
@@ -120,10 +753,10 @@ void Print(const std::vector<std::vector<float>> dataset)
         outFile << "t,y\n";
 
         // Write data points as csv
-        std::vector<float> point;
+        outFile.precision(std::numeric_limits<T>::digits10 + 1);
         for (size_t i = 0; i < dataset.size(); i++)
         {
-            point = dataset[i];
+            const std::vector<T>& point = dataset[i];
             outFile << point[0] << "," << point[1] << "\n";
         }
 
@@ -136,9 +769,330 @@ void Print(const std::vector<std::vector<float>> dataset)
 
 }
 
-int main()
+// Appends rows to solution.csv as a checkpointing solver hands them out,
+// flushing each batch so the file is never behind the saved checkpoint. A new
+// run starts the file with its header; a resumed one adds to it.
+template <typename T>
+typename RungeKuttaSolver<T>::RowSink AppendToCsv(bool newRun)
+{
+    auto outFile = std::make_shared<std::ofstream>("solution.csv", newRun ? std::ios::trunc : std::ios::app);
+    if (!outFile->is_open())
+    {
+        throw std::runtime_error("Unable to open solution.csv");
+    }
+    if (newRun)
+    {
+        *outFile << "t,y\n";
+    }
+    outFile->precision(std::numeric_limits<T>::digits10 + 1);
+
+    return [outFile](const std::vector<std::vector<T>>& out, size_t begin, size_t end)
+    {
+        TraceSpan span("write");
+        for (size_t i = begin; i < end; i++)
+        {
+            *outFile << out[i][0] << "," << out[i][1] << "\n";
+        }
+        outFile->flush();
+        if (!*outFile)
+        {
+            throw std::runtime_error("Unable to write solution.csv");
+        }
+    };
+}
+
+// Cuts a csv file back to its header and first rows data rows, dropping rows
+// written after the last checkpoint by a run that stopped before saving it.
+// Returns false if the file has fewer rows than that.
+bool TrimCsvRows(const std::string& path, long long rows)
+{
+    std::ifstream inFile(path, std::ios::binary);
+    std::string line;
+    for (long long count = 0; count <= rows; count++)
+    {
+        if (!std::getline(inFile, line) || inFile.eof())
+        {
+            return false;
+        }
+    }
+    const std::streamoff keep = inFile.tellg();
+    inFile.close();
+
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) > std::uintmax_t(keep))
+    {
+        std::filesystem::resize_file(path, std::uintmax_t(keep), error);
+    }
+    return !error;
+}
+
+// Settings from the command line that apply to the interactive session
+struct RunOptions
+{
+    Method method = Method::Rk4;
+
+    // Solver class picked by --method, stiff or not; empty for the
+    // Runge-Kutta tableaus of RungeKuttaSolver
+    std::string solver;
+    double tolerance = 0;
+    double outputStep = 0;
+    std::vector<std::pair<std::string, EventAction>> events;
+    std::vector<std::pair<std::string, double>> parameters;
+    std::string fitData;
+    bool fitInitialValue = false;
+    double steadyTolerance = 0;
+    SteadyStateOutput steadyOutput = SteadyStateOutput::Fill;
+    std::string checkpointPath;
+    long long checkpointInterval = 100000;
+    std::string resumePath;
+    size_t windowRows = 0;
+    int summary = 0;
+};
+
+template <typename T>
+bool Configure(RungeKuttaSolver<T>& rk, const RunOptions& options)
+{
+    rk.SetMethod(options.method);
+    rk.SetTolerance(T(options.tolerance));
+    for (const auto& parameter : options.parameters)
+    {
+        if (!rk.SetParameter(parameter.first, T(parameter.second)))
+        {
+            std::cerr << "Invalid parameter name: " << parameter.first << "\n";
+            return false;
+        }
+    }
+    for (const auto& event : options.events)
+    {
+        if (!rk.AddEvent(event.first, event.second))
+        {
+            std::cerr << "Invalid event expression: " << event.first << "\n";
+            return false;
+        }
+    }
+    if (options.steadyTolerance > 0)
+    {
+        SteadyStateOptions<T> steady;
+        steady.enabled = true;
+        steady.derivativeTolerance = T(options.steadyTolerance);
+        steady.changeTolerance = T(options.steadyTolerance);
+        steady.output = options.steadyOutput;
+        rk.SetSteadyState(steady);
+    }
+    if (!options.checkpointPath.empty() && options.resumePath.empty())
+    {
+        rk.SetCheckpoint(options.checkpointPath, options.checkpointInterval, AppendToCsv<T>(true));
+    }
+    return true;
+}
+
+template <typename T>
+bool Configure(RosenbrockSolver<T>& rk, const RunOptions& options)
+{
+    const T tolerance = options.tolerance > 0 ? T(options.tolerance) : T(1e-6);
+    rk.SetTolerances(tolerance, tolerance);
+    return true;
+}
+
+template <typename T>
+bool Configure(BdfSolver<T>& rk, const RunOptions& options)
+{
+    const T tolerance = options.tolerance > 0 ? T(options.tolerance) : T(1e-6);
+    rk.SetTolerances(tolerance, tolerance);
+    return true;
+}
+
+template <typename T>
+bool Configure(BulirschStoerSolver<T>& rk, const RunOptions& options)
+{
+    const T tolerance = options.tolerance > 0 ? T(options.tolerance) : T(1e-6);
+    rk.SetTolerances(tolerance, tolerance);
+    return true;
+}
+
+template <typename T>
+bool Configure(TaylorSolver<T>& rk, const RunOptions& options)
+{
+    const T tolerance = options.tolerance > 0 ? T(options.tolerance) : T(1e-6);
+    rk.SetTolerances(tolerance, tolerance);
+    return true;
+}
+
+template <typename T>
+bool Configure(AutoSwitchingSolver<T>& rk, const RunOptions& options)
+{
+    const T tolerance = options.tolerance > 0 ? T(options.tolerance) : T(1e-6);
+    rk.SetTolerances(tolerance, tolerance);
+    return true;
+}
+
+template <typename T>
+bool Configure(AdamsBashforthMoultonSolver<T>& rk, const RunOptions& options)
+{
+    if (options.method != Method::Rk4 || options.tolerance > 0)
+    {
+        std::cerr << "Adams-Bashforth-Moulton runs on a fixed step with an rk4 start\n";
+        return false;
+    }
+    rk.SetMode(options.solver == "abm-pec" ? AdamsMode::Pec : AdamsMode::Pece);
+    return true;
+}
+
+template <typename T>
+bool Configure(PararealSolver<T>& /*rk*/, const RunOptions& options)
+{
+    if (options.method != Method::Rk4 || options.tolerance > 0)
+    {
+        std::cerr << "Parareal runs fixed-step rk4\n";
+        return false;
+    }
+    return true;
+}
+
+template <typename State>
+bool Configure(MixedPrecisionSolver<State>& /*rk*/, const RunOptions& options)
+{
+    if (options.method != Method::Rk4 || !options.solver.empty() || options.tolerance > 0 || options.outputStep > 0
+        || !options.events.empty() || options.steadyTolerance > 0 || !options.parameters.empty())
+    {
+        std::cerr << "Mixed precision only supports fixed-step rk4\n";
+        return false;
+    }
+    return true;
+}
+
+// Prints solver specific details after a run; most solvers have none
+template <typename Solver>
+void Report(const Solver& /*rk*/)
+{
+}
+
+template <typename T>
+void Report(const RungeKuttaSolver<T>& rk)
+{
+    for (const EventRecord<T>& event : rk.GetEvents())
+    {
+        std::cout << (event.terminal ? "Stopped at event " : "Event ") << event.event << " at t: " << event.t << "  y: " << event.y << std::endl;
+    }
+
+    const SteadyStateStats<T>& steady = rk.GetSteadyStateStats();
+    if (steady.reached)
+    {
+        std::cout << "Steady state at t: " << steady.time << "  skipped " << steady.skippedTime << " time units ("
+            << steady.stepsSkipped << " steps)" << std::endl;
+    }
+}
+
+template <typename T>
+void Report(const PararealSolver<T>& rk)
+{
+    const PararealStats<T>& stats = rk.GetPararealStats();
+    std::cout << "Slices: " << stats.slices << "  Iterations: " << stats.iterations << (stats.converged ? "" : " (not converged)")
+        << "  Critical path: " << stats.criticalPathEvaluations << " of " << rk.GetStats().evaluations << " evaluations" << std::endl;
+}
+
+template <typename T>
+void Report(const AutoSwitchingSolver<T>& rk)
+{
+    const RegimeStats<T>& regimes = rk.GetRegimeStats();
+    std::cout << "Explicit steps: " << regimes.explicitSteps << "  Implicit steps: " << regimes.implicitSteps
+        << "  Switches: " << regimes.switchTimes.size() << std::endl;
+}
+
+// Solves on the solver's own step grid; only RungeKuttaSolver has dense output for --output-step
+template <typename Solver, typename T>
+void SolveForOutput(Solver& rk, const RunOptions& /*options*/, const T& y0, const T& h, const T& tf, const T& t0,
+    const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    rk.Solve(y0, h, tf, t0, expr, out);
+}
+
+// Solves with the rows streamed to a sink that lives only as long as the
+// caller's frame, and detaches it again, even when Solve throws, so rk never
+// keeps a pointer to it
+template <typename T>
+void SolveStreaming(RungeKuttaSolver<T>& rk, size_t rows, typename RungeKuttaSolver<T>::RowSink sink, const T& y0, const T& h,
+    const T& tf, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    rk.SetStreaming(rows, sink);
+    try
+    {
+        rk.Solve(y0, h, tf, t0, expr, out);
+    }
+    catch (...)
+    {
+        rk.SetStreaming(0, {});
+        throw;
+    }
+    rk.SetStreaming(0, {});
+}
+
+template <typename T>
+void SolveForOutput(RungeKuttaSolver<T>& rk, const RunOptions& options, const T& y0, const T& h, const T& tf, const T& t0,
+    const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (options.outputStep > 0)
+    {
+        rk.SolveOnGrid(y0, h, UniformGrid(t0, tf, T(options.outputStep)), expr, out);
+    }
+    else if (options.summary != 0)
+    {
+        // Rows stream through a small batch into the reductions and are not kept
+        TrajectorySummary<T> summary(options.summary);
+        SolveStreaming(rk, 256, summary.Sink(), y0, h, tf, t0, expr, out);
+        out.clear();
+
+        const SummaryValues<T>& values = summary.GetValues();
+        std::cout << "Rows: " << values.rows << "\n";
+        if (options.summary & ReduceExtrema)
+        {
+            std::cout << "Min: " << values.min << " at t: " << values.minTime << "  Max: " << values.max << " at t: " << values.maxTime << "\n";
+        }
+        if (options.summary & ReduceIntegral)
+        {
+            std::cout << "Integral of y: " << values.integral << "\n";
+        }
+        if (options.summary & ReduceCrossings)
+        {
+            std::cout << "Zero crossings: " << values.crossings;
+            if (values.crossings > 0)
+            {
+                std::cout << "  first at t: " << values.firstCrossing << "  last at t: " << values.lastCrossing;
+            }
+            std::cout << "\n";
+        }
+        if (options.summary & ReduceFinal)
+        {
+            std::cout << "Final t: " << values.finalTime << "  y: " << values.finalValue << "\n";
+        }
+        std::cout.flush();
+    }
+    else if (options.windowRows > 0)
+    {
+        // Rows stream through a small batch into the window, so only it is kept
+        SlidingWindow<T> window(options.windowRows);
+        SolveStreaming(rk, 4096, window.Sink(), y0, h, tf, t0, expr, out);
+        window.CopyTo(out);
+
+        const WindowAggregates<T>& all = window.GetAggregates();
+        std::cout << "Over all " << all.count << " rows  min: " << all.min << " at t: " << all.minTime << "  max: " << all.max
+            << " at t: " << all.maxTime << "  mean: " << all.mean << "  variance: " << all.Variance() << std::endl;
+    }
+    else
+    {
+        rk.Solve(y0, h, tf, t0, expr, out);
+    }
+}
+
+// Runs the interactive session with the given solver, which works in scalar type T
+template <typename Solver, typename T>
+int Run(const RunOptions& options)
 {
-    RungeKuttaSolver rk;
+    Solver rk;
+    if (!Configure(rk, options))
+    {
+        return 1;
+    }
 
     std::string expr;
     std::cout <<R"(
@@ -157,7 +1111,7 @@ ______ _   __  ___    ___________ _____    _____       _
     std::cin >> expr;
 
     // Get valid expression
-    while (!rk.IsExpressionValid<float>(expr))
+    while (!rk.IsExpressionValid(expr))
     {
         std::cout << "That expression is invalid, please try again. \nEnter your equation in the form dy/dt = f(y,t) (e.q. t^2+y^2)" << std::endl;
         std::cin >> expr;
@@ -165,31 +1119,49 @@ ______ _   __  ___    ___________ _____    _____       _
 
     // Get valid parameters for integration
     std::string input;
-    float y0 = GetValidFloatInput("Enter a value for initial state (y_0):");
-    float t0 = GetValidFloatInput("Enter the start time (t_0):");
-    float tf = GetValidFloatInput("Enter the final time (t_f):");
-    float h = GetValidFloatInput("Enter the time step (h):");
+    T y0 = GetValidInput<T>("Enter a value for initial state (y_0):");
+    T t0 = GetValidInput<T>("Enter the start time (t_0):");
+    T tf = GetValidInput<T>("Enter the final time (t_f):");
+    T h = GetValidInput<T>("Enter the time step (h):");
 
 
-    std::vector<std::vector<float>> output;
+    std::vector<std::vector<T>> output;
     try
     {
         // Solve and store results
-        rk.Solve(y0, h, tf, t0, expr, output);
+        SolveForOutput(rk, options, y0, h, tf, t0, expr, output);
     }
     catch(std::runtime_error& e)
     {
         std::cout << "An error has occured. Please try again later." << std::endl;
         return 0;
     }
-    
+    Report(rk);
+
+
+    // Display results in prompt; rows end with '\n' so the stream flushes
+    // once per buffer rather than once per row
+    {
+        TraceSpan span("write");
+        for (size_t i = 0; i < output.size(); i++)
+        {
+            const std::vector<T>& entry = output[i];
+            std::cout << "t: " << entry[0]<<  "  y: " << entry[1] << '\n';
+        }
+        std::cout.flush();
+    }
+
+    // A checkpointed run has written its rows to solution.csv already
+    if (!options.checkpointPath.empty())
+    {
+        std::cout << "Results written to solution.csv" << std::endl;
+        return 0;
+    }
 
-    // Display results in prompt
-    std::vector<float> entry;
-    for (size_t i = 0; i < output.size(); i++)
+    // A summary run has no rows to print
+    if (options.summary != 0)
     {
-        entry = output[i];
-        std::cout << "t: " << entry[0]<<  "  y: " << entry[1] << std::endl;
+        return 0;
     }
 
     // Determine if we should print to csv
@@ -212,4 +1184,369 @@ ______ _   __  ___    ___________ _____    _____       _
     return 0;
 }
 
+// Fits the --param parameters (and y0 with --fit-y0) to the --fit data
+// instead of printing a solution
+template <typename T>
+int RunFit(const RunOptions& options)
+{
+    ParameterFitter<T> fitter;
+    if (!fitter.LoadData(options.fitData))
+    {
+        std::cerr << "Could not read t,y data from " << options.fitData << "\n";
+        return 1;
+    }
+    for (const auto& parameter : options.parameters)
+    {
+        if (!fitter.AddParameter(parameter.first, T(parameter.second)))
+        {
+            std::cerr << "Invalid parameter name: " << parameter.first << "\n";
+            return 1;
+        }
+    }
+    fitter.SetFitInitialValue(options.fitInitialValue);
+
+    std::string expr;
+    std::cout << "Fitting " << fitter.GetTimes().size() << " data points from " << options.fitData << std::endl;
+    std::cout << "Please enter your expression for f(y,t) using the parameters to fit (e.g. -k*y)" << std::endl;
+    std::cin >> expr;
+    while (!fitter.IsExpressionValid(expr))
+    {
+        std::cout << "That expression is invalid or uses operators the fitter cannot differentiate, please try again." << std::endl;
+        std::cin >> expr;
+    }
+
+    T y0 = GetValidInput<T>(options.fitInitialValue ? "Enter a first guess for the initial state (y_0):" : "Enter a value for initial state (y_0):");
+    T t0 = GetValidInput<T>("Enter the start time (t_0):");
+    T h = GetValidInput<T>("Enter the time step (h):");
+
+    FitResult<T> result;
+    try
+    {
+        result = fitter.Fit(y0, h, t0, expr);
+    }
+    catch (std::runtime_error& e)
+    {
+        std::cout << "An error has occured: " << e.what() << std::endl;
+        return 1;
+    }
+
+    for (size_t j = 0; j < options.parameters.size(); j++)
+    {
+        std::cout << options.parameters[j].first << ": " << result.values[j] << "\n";
+    }
+    if (options.fitInitialValue)
+    {
+        std::cout << "y0: " << result.initialValue << "\n";
+    }
+    std::cout << "Residual sum of squares: " << 2 * result.cost << "  Iterations: " << result.iterations
+        << (result.converged ? "" : " (not converged)") << "  Solves: " << result.solves << std::endl;
+    return 0;
+}
+
+// Continues the run checkpointed in --resume without prompting, appending the
+// rest of its rows to the solution.csv it was writing
+template <typename T>
+int RunResume(const RunOptions& options)
+{
+    SolverCheckpoint<T> checkpoint;
+    if (!LoadCheckpoint(options.resumePath, checkpoint))
+    {
+        std::cerr << "Could not read checkpoint " << options.resumePath << " (it must be resumed with the --precision it was saved with)\n";
+        return 1;
+    }
+    if (!TrimCsvRows("solution.csv", checkpoint.rows))
+    {
+        std::cerr << "solution.csv holds fewer rows than checkpoint " << options.resumePath << "\n";
+        return 1;
+    }
+
+    RungeKuttaSolver<T> rk;
+    if (!Configure(rk, options))
+    {
+        return 1;
+    }
+    const std::string& path = options.checkpointPath.empty() ? options.resumePath : options.checkpointPath;
+    rk.SetCheckpoint(path, options.checkpointInterval, AppendToCsv<T>(false));
+
+    std::cout << "Resuming " << checkpoint.expression << " at t: " << checkpoint.time << "  y: " << checkpoint.y
+        << " towards t: " << checkpoint.t << std::endl;
+
+    std::vector<std::vector<T>> output;
+    try
+    {
+        rk.Resume(options.resumePath, output);
+    }
+    catch (std::runtime_error& e)
+    {
+        std::cout << "An error has occured: " << e.what() << std::endl;
+        return 1;
+    }
+    Report(rk);
+
+    {
+        TraceSpan span("write");
+        for (size_t i = 0; i < output.size(); i++)
+        {
+            const std::vector<T>& entry = output[i];
+            std::cout << "t: " << entry[0] << "  y: " << entry[1] << '\n';
+        }
+    }
+    std::cout << "Results appended to solution.csv" << std::endl;
+    return 0;
+}
+
+// Runs the interactive session with the solver selected by --method in scalar type T
+template <typename T>
+int RunWithSolver(const RunOptions& options)
+{
+    if (!options.fitData.empty())
+    {
+        return RunFit<T>(options);
+    }
+    if (!options.resumePath.empty())
+    {
+        return RunResume<T>(options);
+    }
+    if (options.solver == "rosenbrock")
+    {
+        return Run<RosenbrockSolver<T>, T>(options);
+    }
+    else if (options.solver == "bdf")
+    {
+        return Run<BdfSolver<T>, T>(options);
+    }
+    else if (options.solver == "auto")
+    {
+        return Run<AutoSwitchingSolver<T>, T>(options);
+    }
+    else if (options.solver == "gbs")
+    {
+        return Run<BulirschStoerSolver<T>, T>(options);
+    }
+    else if (options.solver == "taylor")
+    {
+        return Run<TaylorSolver<T>, T>(options);
+    }
+    else if (options.solver == "parareal")
+    {
+        return Run<PararealSolver<T>, T>(options);
+    }
+    else if (options.solver == "abm" || options.solver == "abm-pec")
+    {
+        return Run<AdamsBashforthMoultonSolver<T>, T>(options);
+    }
+    return Run<RungeKuttaSolver<T>, T>(options);
+}
+
+int main(int argc, char* argv[])
+{
+    // Optional flags:
+    //   --trace <file>          write a Chrome trace of the run on exit
+    //   --precision <type>      float (default), double, long-double, mixed or mixed-double
+    //   --benchmark <name>      run a benchmark instead of the interactive session
+    //   --method <name>         Runge-Kutta tableau, e.g. rk4 (default), rk5, dopri5,
+    //                           the stiff solvers rosenbrock and bdf, auto switching,
+    //                           the multistep abm and abm-pec, gbs extrapolation
+    //                           taylor series or parareal (parallel-in-time rk4)
+    //   --tolerance <tol>       adaptive step size control for embedded pairs and stiff solvers
+    //   --output-step <dt>      report the solution every dt by dense output, whatever the step size
+    //   --event <expr>          report where g(t, y) = expr changes sign (repeatable)
+    //   --stop-event <expr>     as --event, and end the integration there
+    //   --steady-state <tol>    stop once |f| and |dy| stay below tol for 10 steps
+    //   --steady-output <mode>  fill (default) repeats the steady value to t_f, truncate ends the output
+    //   --param <name>=<value>  named constant for the expression, e.g. --param k=0.5 for -k*y (repeatable)
+    //   --fit <csv>             fit the --param parameters to t,y data by Levenberg-Marquardt
+    //   --fit-y0                also fit the initial value
+    //   --checkpoint <file>     save the run state every --checkpoint-every steps, streaming rows to solution.csv
+    //   --checkpoint-every <n>  accepted steps between checkpoints (default 100000)
+    //   --resume <file>         continue a checkpointed run, appending to solution.csv
+    //   --window <n>            keep only the last n rows, with min, max, mean and variance over all of them
+    //   --summary <list>        print only extrema, integral, crossings and/or final (comma-separated, or all)
+    std::string precision = "float";
+    std::string benchmark;
+    RunOptions options;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        std::string flag = argv[arg];
+        if (flag == "--trace" && arg + 1 < argc)
+        {
+            Tracer::Enable(argv[++arg]);
+        }
+        else if (flag == "--precision" && arg + 1 < argc)
+        {
+            precision = argv[++arg];
+        }
+        else if (flag == "--benchmark" && arg + 1 < argc)
+        {
+            benchmark = argv[++arg];
+        }
+        else if (flag == "--method" && arg + 1 < argc)
+        {
+            const std::string name = argv[++arg];
+            if (name == "rosenbrock" || name == "bdf" || name == "auto" || name == "abm" || name == "abm-pec" || name == "gbs"
+                || name == "taylor" || name == "parareal")
+            {
+                options.solver = name;
+            }
+            else if (!ParseMethod(name, options.method))
+            {
+                std::cerr << "Unknown method: " << name << " (expected euler, heun, rk3, rk4, rk38, rk5, bs32, dopri5, rosenbrock, bdf, auto, abm, abm-pec, gbs, taylor or parareal)\n";
+                return 1;
+            }
+        }
+        else if (flag == "--tolerance" && arg + 1 < argc)
+        {
+            options.tolerance = std::atof(argv[++arg]);
+        }
+        else if (flag == "--output-step" && arg + 1 < argc)
+        {
+            options.outputStep = std::atof(argv[++arg]);
+        }
+        else if (flag == "--event" && arg + 1 < argc)
+        {
+            options.events.push_back({ argv[++arg], EventAction::Record });
+        }
+        else if (flag == "--stop-event" && arg + 1 < argc)
+        {
+            options.events.push_back({ argv[++arg], EventAction::Terminate });
+        }
+        else if (flag == "--steady-state" && arg + 1 < argc)
+        {
+            options.steadyTolerance = std::atof(argv[++arg]);
+        }
+        else if (flag == "--param" && arg + 1 < argc)
+        {
+            const std::string assignment = argv[++arg];
+            const size_t equals = assignment.find('=');
+            if (equals == std::string::npos || equals == 0)
+            {
+                std::cerr << "Expected --param <name>=<value>, got: " << assignment << "\n";
+                return 1;
+            }
+            options.parameters.push_back({ assignment.substr(0, equals), std::atof(assignment.c_str() + equals + 1) });
+        }
+        else if (flag == "--fit" && arg + 1 < argc)
+        {
+            options.fitData = argv[++arg];
+        }
+        else if (flag == "--fit-y0")
+        {
+            options.fitInitialValue = true;
+        }
+        else if (flag == "--checkpoint" && arg + 1 < argc)
+        {
+            options.checkpointPath = argv[++arg];
+        }
+        else if (flag == "--checkpoint-every" && arg + 1 < argc)
+        {
+            options.checkpointInterval = std::atoll(argv[++arg]);
+            if (options.checkpointInterval < 1)
+            {
+                std::cerr << "--checkpoint-every needs a positive number of steps\n";
+                return 1;
+            }
+        }
+        else if (flag == "--resume" && arg + 1 < argc)
+        {
+            options.resumePath = argv[++arg];
+        }
+        else if (flag == "--summary" && arg + 1 < argc)
+        {
+            const std::string list = argv[++arg];
+            if (!ParseReductions(list, options.summary))
+            {
+                std::cerr << "Unknown summary: " << list << " (expected a comma-separated list of extrema, integral, crossings and final, or all)\n";
+                return 1;
+            }
+        }
+        else if (flag == "--window" && arg + 1 < argc)
+        {
+            const long long rows = std::atoll(argv[++arg]);
+            if (rows < 1)
+            {
+                std::cerr << "--window needs a positive number of rows\n";
+                return 1;
+            }
+            options.windowRows = size_t(rows);
+        }
+        else if (flag == "--steady-output" && arg + 1 < argc)
+        {
+            const std::string mode = argv[++arg];
+            if (mode != "fill" && mode != "truncate")
+            {
+                std::cerr << "Unknown steady state output: " << mode << " (expected fill or truncate)\n";
+                return 1;
+            }
+            options.steadyOutput = mode == "fill" ? SteadyStateOutput::Fill : SteadyStateOutput::Truncate;
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << flag << "\n";
+            return 1;
+        }
+    }
+
+    if (!benchmark.empty())
+    {
+        return RunBenchmark(benchmark);
+    }
+
+    if ((options.outputStep > 0 || !options.events.empty() || options.steadyTolerance > 0 || !options.parameters.empty())
+        && !options.solver.empty())
+    {
+        std::cerr << "--output-step, events, steady state detection and parameters are only supported by the Runge-Kutta methods\n";
+        return 1;
+    }
+
+    if (options.summary != 0 && (options.windowRows > 0 || !options.solver.empty() || options.outputStep > 0 || !options.checkpointPath.empty()
+        || !options.resumePath.empty() || !options.fitData.empty() || precision == "mixed" || precision == "mixed-double"))
+    {
+        std::cerr << "--summary is supported by the Runge-Kutta methods on their own step grid, without --window or checkpoints\n";
+        return 1;
+    }
 
+    if (options.windowRows > 0 && (!options.solver.empty() || options.outputStep > 0 || !options.checkpointPath.empty()
+        || !options.resumePath.empty() || !options.fitData.empty() || precision == "mixed" || precision == "mixed-double"))
+    {
+        std::cerr << "--window is supported by the Runge-Kutta methods on their own step grid, without checkpoints\n";
+        return 1;
+    }
+
+    if ((!options.checkpointPath.empty() || !options.resumePath.empty()) && (!options.solver.empty() || options.outputStep > 0
+        || !options.fitData.empty() || precision == "mixed" || precision == "mixed-double"))
+    {
+        std::cerr << "--checkpoint and --resume are supported by the Runge-Kutta methods on their own step grid in float, double or long-double precision\n";
+        return 1;
+    }
+
+    if (!options.fitData.empty() && (options.method != Method::Rk4 || !options.solver.empty() || options.tolerance > 0 || options.outputStep > 0
+        || !options.events.empty() || options.steadyTolerance > 0 || precision == "mixed" || precision == "mixed-double"))
+    {
+        std::cerr << "--fit integrates with fixed-step rk4 in float, double or long-double precision\n";
+        return 1;
+    }
+
+    if (precision == "float")
+    {
+        return RunWithSolver<float>(options);
+    }
+    else if (precision == "double")
+    {
+        return RunWithSolver<double>(options);
+    }
+    else if (precision == "long-double")
+    {
+        return RunWithSolver<long double>(options);
+    }
+    else if (precision == "mixed")
+    {
+        return Run<MixedPrecisionSolver<CompensatedFloat>, double>(options);
+    }
+    else if (precision == "mixed-double")
+    {
+        return Run<MixedPrecisionSolver<double>, double>(options);
+    }
+
+    std::cerr << "Unknown precision: " << precision << " (expected float, double, long-double, mixed or mixed-double)\n";
+    return 1;
+}
@@ -1,61 +1,158 @@
 #pragma once
+#include <functional>
 #include <string>
 #include <vector>
-#include "exprtk.hpp"
+#include "ButcherTableau.h"
+#include "Checkpoint.h"
+#include "EventSet.h"
+#include "OdeExpression.h"
+#include "SolverStats.h"
+#include "SteadyState.h"
 
+// Explicit Runge-Kutta integrator, classic RK4 unless another tableau is
+// selected. T is the scalar type used for the state, the time and the exprtk
+// evaluation; float, double and long double are instantiated.
+template <typename T>
 class RungeKuttaSolver
 {
 public:
 
+    // Receives rows [begin, end) of the output as soon as they are final
+    typedef std::function<void(const std::vector<std::vector<T>>& out, size_t begin, size_t end)> RowSink;
+
     RungeKuttaSolver();
 
-    void Solve(const float& y0, const float& h, const float& t, const float& t0,
-        const std::string& expr, std::vector<std::vector<float>>& out);
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
 
-    template <typename T>
-    bool IsExpressionValid(const std::string& expression_str)
-    {
-        typedef exprtk::symbol_table<T> symbol_table_t;
-        typedef exprtk::expression<T> expression_t;
-        typedef exprtk::parser<T>       parser_t;
+    // Integrates from grid.front() to grid.back() and writes one row per grid
+    // point, interpolated within the steps, so h (or the tolerance) only sets
+    // the accuracy and the output grid can be as fine as needed
+    void SolveOnGrid(const T& y0, const T& h, const std::vector<T>& grid,
+        const std::string& expr, std::vector<std::vector<T>>& out);
 
-        symbol_table_t symbol_table;
-        float t = 0.0;
-        float y = 0.0;
-        symbol_table.add_variable("t", t);
-        symbol_table.add_variable("y", y);
+    // Solves once for each value of the named parameter. The expression is
+    // compiled once and the parameter updated in place between the runs, so a
+    // sweep costs no more parsing than a single Solve. out[i] receives the
+    // trajectory for values[i] and the stats are totals over all runs.
+    void SolveSweep(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr,
+        const std::string& parameter, const std::vector<T>& values, std::vector<std::vector<std::vector<T>>>& out);
 
-        expression_t expression;
-        expression.register_symbol_table(symbol_table);
+    bool IsExpressionValid(const std::string& expression_str);
 
-        parser_t parser;
-        return parser.compile(expression_str, expression);
-    }
+    // Named constant the expression can use, e.g. k in -k*y; see
+    // OdeExpression::SetParameter. Returns false if the name is not allowed.
+    bool SetParameter(const std::string& name, const T& value);
+
+    void SetMethod(Method method);
+
+    Method GetMethod() const;
+
+    void SetTolerance(const T& tolerance);
+
+    // Adds an event function g(t, y). Solve records where it changes sign
+    // and, for a terminal event, ends the output at that point. Returns false
+    // if the expression is invalid.
+    bool AddEvent(const std::string& expression, EventAction action);
+
+    void ClearEvents();
+
+    // Events fired during the last Solve
+    const std::vector<EventRecord<T>>& GetEvents() const;
+
+    // Stops integrating once the solution has settled, see SteadyStateMonitor
+    void SetSteadyState(const SteadyStateOptions<T>& options);
+
+    // Whether and where the last Solve settled
+    const SteadyStateStats<T>& GetSteadyStateStats() const;
+
+    // Every interval accepted steps, Solve and Resume save their state to
+    // path, and they remove the file once the run completes. The rows up to
+    // each checkpoint go to sink, if set, before the checkpoint is saved, and
+    // the rest when the run ends, so whatever the sink appends to is never
+    // behind the checkpoint. Solve still fills its output as usual. An empty
+    // path turns checkpointing off.
+    void SetCheckpoint(const std::string& path, long long interval, RowSink sink = RowSink());
+
+    // Continues the run saved at path to its original final time with the
+    // saved method and tolerance. out receives only the rows after the
+    // checkpoint, the first being row checkpoint.rows of the whole run, and
+    // the stats continue from the saved ones. Parameters and events must be
+    // set as they were. Throws std::runtime_error if the file cannot be read
+    // or a saved parameter is missing or has another value.
+    void Resume(const std::string& path, std::vector<std::vector<T>>& out);
+
+    // Hands the rows of Solve, Resume and Continue to sink in batches of at
+    // most rows, keeping only the current batch, so memory stays the same
+    // however many steps a run takes; out ends up holding the last batch.
+    // The sink is the one SetCheckpoint sets. 0 rows keeps every row again.
+    void SetStreaming(size_t rows, RowSink sink);
+
+    // Carries the last completed Solve, Resume or Continue on to a later t
+    // from its final state, without recompiling and on the same step grid, so
+    // only the new interval is integrated. out receives only the new rows,
+    // and the stats count the whole run. Does nothing if t is not past the
+    // last row. Throws std::runtime_error if the last run stopped early.
+    void Continue(const T& t, std::vector<std::vector<T>>& out);
+
+    const SolverStats& GetStats() const;
 
 private:
 
-    template <typename T>
-    const float dydt(T t, T y, const std::string& expression_string )
+    static const int TraceBatchSize = 256;
+
+    void CompileExpression(const std::string& expression_string);
+
+    // Runs Solve or Resume from start, which is at the beginning or a checkpoint
+    void Integrate(const SolverCheckpoint<T>& start, std::vector<std::vector<T>>& out);
+
+    template <typename Tableau>
+    void IntegrateFixed(const SolverCheckpoint<T>& start, std::vector<std::vector<T>>& out);
+
+    template <typename Tableau>
+    void IntegrateAdaptive(const SolverCheckpoint<T>& start, std::vector<std::vector<T>>& out);
+
+    // Hands out[delivered - outputOffset, end) to the sink
+    void Deliver(const std::vector<std::vector<T>>& out, size_t end);
+
+    // Hands the rows up to the saved point to the sink, then saves the state
+    void SaveProgress(long long index, const T& time, const T& y, const T& step, const T& slope, long long rows,
+        const std::vector<std::vector<T>>& out);
+
+    // Sets progress to the state after index accepted steps
+    void Record(long long index, const T& time, const T& y, const T& step, const T& slope, long long rows);
+
+    template <typename Tableau>
+    void IntegrateDense(const T& y0, const T& h0, const std::vector<T>& grid, std::vector<std::vector<T>>& out);
+
+    template <typename Tableau>
+    bool StopAtEvent(const T& t0, const T& y0, const T& f0, const T& kLast, T& t1, T& y1);
+
+    void RecordSteadyState(const T& time, const T& t, long long stepsSkipped);
+
+    T dydt(const T& t, const T& y)
     {
-        typedef exprtk::symbol_table<T> symbol_table_t;
-        typedef exprtk::expression<T> expression_t;
-        typedef exprtk::parser<T>       parser_t;
-
-        symbol_table_t symbol_table;
-        symbol_table.add_variable("t", t);
-        symbol_table.add_variable("y", y);
-        symbol_table.add_constants();
-
-        expression_t expression;
-        expression.register_symbol_table(symbol_table);
- 
-        parser_t parser;
-        parser.compile(expression_string, expression);
-
-        return static_cast<float>(expression.value());
+        stats.evaluations++;
+        return expression.Evaluate(t, y);
     }
 
-     
+    OdeExpression<T> expression;
+    Method method = Method::Rk4;
+    T tolerance = T(0);
+    EventSet<T> events;
+    SteadyStateMonitor<T> steadyState;
+    SteadyStateStats<T> steadyStats;
 
-};
+    std::string checkpointPath;
+    long long checkpointInterval = 0;
+    RowSink sink;
+    size_t streamRows = 0;
+    SolverCheckpoint<T> progress;
+
+    // Rows of the run handed to the sink, and rows before out[0]
+    long long delivered = 0;
+    long long outputOffset = 0;
+    bool continuable = false;
 
+    SolverStats stats;
+};
@@ -0,0 +1,275 @@
+#include "SensitivityExpression.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+
+template <typename T>
+SensitivityExpression<T>::SensitivityExpression()
+{
+}
+
+template <typename T>
+bool SensitivityExpression<T>::Compile(const std::string& expression, const std::vector<std::string>& parameters)
+{
+    if (compiled && source == expression && names == parameters)
+    {
+        return true;
+    }
+
+    TraceSpan span("compile");
+
+    compiled = tape.Compile(expression, parameters);
+    source = compiled ? expression : std::string();
+    names = compiled ? parameters : std::vector<std::string>();
+    parameterValues.resize(names.size(), T(0));
+    directions = 1 + int(names.size());
+    values.assign(tape.GetNodes().size(), T(0));
+    gradients.assign(tape.GetNodes().size() * directions, T(0));
+    adjoints.assign(tape.GetNodes().size(), T(0));
+    return compiled;
+}
+
+template <typename T>
+bool SensitivityExpression<T>::IsCompiled() const
+{
+    return compiled;
+}
+
+template <typename T>
+const std::string& SensitivityExpression<T>::GetExpression() const
+{
+    return source;
+}
+
+template <typename T>
+int SensitivityExpression<T>::GetParameterCount() const
+{
+    return int(names.size());
+}
+
+template <typename T>
+void SensitivityExpression<T>::SetParameterValue(int index, const T& value)
+{
+    parameterValues[index] = value;
+}
+
+// Each node's gradient is the chain rule applied to its operands' gradients:
+// c = g(a, b) gives dc = g_a da + g_b db in every direction at once
+template <typename T>
+T SensitivityExpression<T>::Evaluate(const T& t, const T& y, T* partials)
+{
+    const std::vector<Node>& nodes = tape.GetNodes();
+    const int count = int(nodes.size());
+    const int d = directions;
+
+    for (int n = 0; n < count; n++)
+    {
+        const Node& node = nodes[n];
+        T& c = values[n];
+        T* dc = &gradients[size_t(n) * d];
+        const T a = node.left >= 0 ? values[node.left] : T(0);
+        const T b = node.right >= 0 ? values[node.right] : T(0);
+        const T* da = node.left >= 0 ? &gradients[size_t(node.left) * d] : nullptr;
+        const T* db = node.right >= 0 ? &gradients[size_t(node.right) * d] : nullptr;
+
+        // dc = scale * da, for the unary operations
+        auto chain = [&](const T& scale)
+        {
+            for (int k = 0; k < d; k++)
+            {
+                dc[k] = scale * da[k];
+            }
+        };
+
+        switch (node.op)
+        {
+        case Op::Constant:
+        case Op::Time:
+        case Op::State:
+        case Op::Parameter:
+        {
+            // Seeds: y is direction 0 and parameter j direction 1 + j
+            c = node.op == Op::Constant ? node.value : node.op == Op::Time ? t : node.op == Op::State ? y
+                : parameterValues[int(node.value)];
+            const int seed = node.op == Op::State ? 0 : node.op == Op::Parameter ? 1 + int(node.value) : -1;
+            for (int k = 0; k < d; k++)
+            {
+                dc[k] = k == seed ? T(1) : T(0);
+            }
+            break;
+        }
+        case Op::Add:
+            c = a + b;
+            for (int k = 0; k < d; k++)
+            {
+                dc[k] = da[k] + db[k];
+            }
+            break;
+        case Op::Subtract:
+            c = a - b;
+            for (int k = 0; k < d; k++)
+            {
+                dc[k] = da[k] - db[k];
+            }
+            break;
+        case Op::Multiply:
+            c = a * b;
+            for (int k = 0; k < d; k++)
+            {
+                dc[k] = da[k] * b + a * db[k];
+            }
+            break;
+        case Op::Divide:
+            c = a / b;
+            for (int k = 0; k < d; k++)
+            {
+                dc[k] = (da[k] - c * db[k]) / b;
+            }
+            break;
+        case Op::Negate:
+            c = -a;
+            chain(T(-1));
+            break;
+        case Op::Exp:
+            c = std::exp(a);
+            chain(c);
+            break;
+        case Op::Log:
+            c = std::log(a);
+            chain(T(1) / a);
+            break;
+        case Op::Sqrt:
+            c = std::sqrt(a);
+            chain(T(1) / (2 * c));
+            break;
+        case Op::Sin:
+            c = std::sin(a);
+            chain(std::cos(a));
+            break;
+        case Op::Cos:
+            c = std::cos(a);
+            chain(-std::sin(a));
+            break;
+        case Op::Tan:
+            c = std::tan(a);
+            chain(1 + c * c);
+            break;
+        case Op::Sinh:
+            c = std::sinh(a);
+            chain(std::cosh(a));
+            break;
+        case Op::Cosh:
+            c = std::cosh(a);
+            chain(std::sinh(a));
+            break;
+        case Op::Power:
+            c = std::pow(a, node.value);
+            chain(node.value * std::pow(a, node.value - 1));
+            break;
+        }
+    }
+
+    const int root = tape.GetRoot();
+    for (int k = 0; k < d; k++)
+    {
+        partials[k] = gradients[size_t(root) * d + k];
+    }
+    return values[root];
+}
+
+template <typename T>
+void SensitivityExpression<T>::ForwardValues(const T& t, const T& y)
+{
+    const std::vector<Node>& nodes = tape.GetNodes();
+    const int count = int(nodes.size());
+    for (int n = 0; n < count; n++)
+    {
+        const Node& node = nodes[n];
+        const T a = node.left >= 0 ? values[node.left] : T(0);
+        const T b = node.right >= 0 ? values[node.right] : T(0);
+        T& c = values[n];
+        switch (node.op)
+        {
+        case Op::Constant: c = node.value; break;
+        case Op::Time: c = t; break;
+        case Op::State: c = y; break;
+        case Op::Parameter: c = parameterValues[int(node.value)]; break;
+        case Op::Add: c = a + b; break;
+        case Op::Subtract: c = a - b; break;
+        case Op::Multiply: c = a * b; break;
+        case Op::Divide: c = a / b; break;
+        case Op::Negate: c = -a; break;
+        case Op::Exp: c = std::exp(a); break;
+        case Op::Log: c = std::log(a); break;
+        case Op::Sqrt: c = std::sqrt(a); break;
+        case Op::Sin: c = std::sin(a); break;
+        case Op::Cos: c = std::cos(a); break;
+        case Op::Tan: c = std::tan(a); break;
+        case Op::Sinh: c = std::sinh(a); break;
+        case Op::Cosh: c = std::cosh(a); break;
+        case Op::Power: c = std::pow(a, node.value); break;
+        }
+    }
+}
+
+template <typename T>
+T SensitivityExpression<T>::Value(const T& t, const T& y)
+{
+    ForwardValues(t, y);
+    return values[tape.GetRoot()];
+}
+
+// Each node passes its adjoint on to its operands scaled by the partial
+// derivatives of the operation, last node first
+template <typename T>
+T SensitivityExpression<T>::AccumulateAdjoint(const T& t, const T& y, const T& weight, T& dy, T* dp)
+{
+    ForwardValues(t, y);
+
+    const std::vector<Node>& nodes = tape.GetNodes();
+    const int root = tape.GetRoot();
+    std::fill(adjoints.begin(), adjoints.begin() + root + 1, T(0));
+    adjoints[root] = weight;
+
+    for (int n = root; n >= 0; n--)
+    {
+        const T bar = adjoints[n];
+        if (bar == T(0))
+        {
+            continue;
+        }
+
+        const Node& node = nodes[n];
+        const T c = values[n];
+        const T a = node.left >= 0 ? values[node.left] : T(0);
+        const T b = node.right >= 0 ? values[node.right] : T(0);
+        T* aBar = node.left >= 0 ? &adjoints[node.left] : nullptr;
+        T* bBar = node.right >= 0 ? &adjoints[node.right] : nullptr;
+
+        switch (node.op)
+        {
+        case Op::Constant: case Op::Time: break;
+        case Op::State: dy += bar; break;
+        case Op::Parameter: dp[int(node.value)] += bar; break;
+        case Op::Add: *aBar += bar; *bBar += bar; break;
+        case Op::Subtract: *aBar += bar; *bBar -= bar; break;
+        case Op::Multiply: *aBar += bar * b; *bBar += bar * a; break;
+        case Op::Divide: *aBar += bar / b; *bBar -= bar * c / b; break;
+        case Op::Negate: *aBar -= bar; break;
+        case Op::Exp: *aBar += bar * c; break;
+        case Op::Log: *aBar += bar / a; break;
+        case Op::Sqrt: *aBar += bar / (2 * c); break;
+        case Op::Sin: *aBar += bar * std::cos(a); break;
+        case Op::Cos: *aBar -= bar * std::sin(a); break;
+        case Op::Tan: *aBar += bar * (1 + c * c); break;
+        case Op::Sinh: *aBar += bar * std::cosh(a); break;
+        case Op::Cosh: *aBar += bar * std::sinh(a); break;
+        case Op::Power: *aBar += bar * node.value * std::pow(a, node.value - 1); break;
+        }
+    }
+    return values[root];
+}
+
+template class SensitivityExpression<float>;
+template class SensitivityExpression<double>;
+template class SensitivityExpression<long double>;
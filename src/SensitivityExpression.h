@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "ExpressionTape.h"
+
+// Right-hand side f(t, y; p) with its exact partial derivatives in y and in
+// each named parameter, by automatic differentiation over the ExpressionTape.
+// Forward mode carries every node's value together with its gradient in
+// (y, p_1 .. p_n), which gives the Jacobian terms of the forward sensitivity
+// equations. Reverse mode runs back over the tape once after the values and
+// gives a weighted gradient at a cost that does not grow with the number of
+// parameters, which is what adjoint methods need.
+template <typename T>
+class SensitivityExpression
+{
+public:
+
+    SensitivityExpression();
+
+    // Parameter names are matched like exprtk variables, ignoring case.
+    // Recompiling the same expression and names is a no-op.
+    bool Compile(const std::string& expression, const std::vector<std::string>& parameters);
+
+    bool IsCompiled() const;
+
+    const std::string& GetExpression() const;
+
+    int GetParameterCount() const;
+
+    void SetParameterValue(int index, const T& value);
+
+    // f(t, y); partials[0] receives df/dy and partials[1 + j] df/dp_j
+    T Evaluate(const T& t, const T& y, T* partials);
+
+    // f(t, y) without derivatives
+    T Value(const T& t, const T& y);
+
+    // Reverse mode: adds weight df/dy to dy and weight df/dp_j to dp[j], and
+    // returns f(t, y)
+    T AccumulateAdjoint(const T& t, const T& y, const T& weight, T& dy, T* dp);
+
+private:
+
+    typedef typename ExpressionTape<T>::Op Op;
+    typedef typename ExpressionTape<T>::Node Node;
+
+    // Node values only, into values
+    void ForwardValues(const T& t, const T& y);
+
+    ExpressionTape<T> tape;
+    std::string source;
+    std::vector<std::string> names;
+    bool compiled = false;
+
+    std::vector<T> parameterValues;
+    int directions = 1;
+    std::vector<T> values;
+    std::vector<T> gradients;
+    std::vector<T> adjoints;
+};
@@ -0,0 +1,247 @@
+#include "SensitivitySolver.h"
+#include "ButcherTableau.h"
+#include "DenseOutput.h"
+#include "Tracer.h"
+#include <cmath>
+#include <stdexcept>
+
+template <typename T>
+SensitivitySolver<T>::SensitivitySolver()
+{
+}
+
+template <typename T>
+void SensitivitySolver<T>::CompileExpression(const std::string& expression_string)
+{
+    if (!expression.Compile(expression_string, names))
+    {
+        throw std::runtime_error("Invalid expression: " + expression_string);
+    }
+}
+
+template <typename T>
+bool SensitivitySolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str, names);
+}
+
+template <typename T>
+bool SensitivitySolver<T>::SetParameter(const std::string& name, const T& value)
+{
+    for (size_t index = 0; index < names.size(); index++)
+    {
+        if (names[index] == name)
+        {
+            parameterValues[index] = value;
+            return true;
+        }
+    }
+
+    if (!ExpressionTape<T>::IsParameterName(name))
+    {
+        return false;
+    }
+
+    names.push_back(name);
+    parameterValues.push_back(value);
+    return true;
+}
+
+template <typename T>
+const std::vector<std::string>& SensitivitySolver<T>::GetParameterNames() const
+{
+    return names;
+}
+
+template <typename T>
+void SensitivitySolver<T>::SetInitialValueSensitivity(bool enabled)
+{
+    initialValue = enabled;
+}
+
+template <typename T>
+const SolverStats& SensitivitySolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+void SensitivitySolver<T>::Derivative(const T& t, const std::vector<T>& z, std::vector<T>& dz)
+{
+    stats.evaluations++;
+    const int parameters = int(names.size());
+    dz[0] = expression.Evaluate(t, z[0], partials.data());
+    for (int j = 0; j < parameters; j++)
+    {
+        dz[1 + j] = partials[0] * z[1 + j] + partials[1 + j];
+    }
+    if (initialValue)
+    {
+        dz[1 + parameters] = partials[0] * z[1 + parameters];
+    }
+}
+
+template <typename T>
+int SensitivitySolver<T>::Start(const T& y0, const std::string& expr)
+{
+    CompileExpression(expr);
+    stats = SolverStats();
+    for (size_t index = 0; index < names.size(); index++)
+    {
+        expression.SetParameterValue(int(index), parameterValues[index]);
+    }
+
+    const int size = 1 + int(names.size()) + (initialValue ? 1 : 0);
+    partials.assign(1 + names.size(), T(0));
+    for (std::vector<T>* buffer : { &k1, &k2, &k3, &k4, &stage, &z, &previous, &previousSlope })
+    {
+        buffer->assign(size, T(0));
+    }
+
+    z[0] = y0;
+    if (initialValue)
+    {
+        z[size - 1] = T(1);
+    }
+    return size;
+}
+
+// The classic RK4 stages, applied to every component of z
+template <typename T>
+void SensitivitySolver<T>::Step(const T& time, const T& h)
+{
+    const int size = int(z.size());
+    const T half = T(Rk4Tableau::C[1]);
+    for (int c = 0; c < size; c++)
+    {
+        stage[c] = z[c] + h * (half * k1[c]);
+    }
+    Derivative(time + half * h, stage, k2);
+    for (int c = 0; c < size; c++)
+    {
+        stage[c] = z[c] + h * (half * k2[c]);
+    }
+    Derivative(time + half * h, stage, k3);
+    for (int c = 0; c < size; c++)
+    {
+        stage[c] = z[c] + h * k3[c];
+    }
+    Derivative(time + h, stage, k4);
+    for (int c = 0; c < size; c++)
+    {
+        z[c] = z[c] + h * (T(Rk4Tableau::B[0]) * k1[c] + T(Rk4Tableau::B[1]) * k2[c]
+            + T(Rk4Tableau::B[2]) * k3[c] + T(Rk4Tableau::B[3]) * k4[c]);
+    }
+}
+
+// Fixed steps of size h; the output holds ceil((t - t0) / h) + 1 points
+template <typename T>
+void SensitivitySolver<T>::Solve(const T& y0, const T& h, const T& t, const T& t0,
+    const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    const int size = Start(y0, expr);
+    TraceSpan solveSpan("solve");
+
+    const int x = int(std::ceil((t - t0) / h)) + 1;
+    out.assign(x, std::vector<T>(1 + size));
+    auto record = [&](int row, const T& time)
+    {
+        std::vector<T>& entry = out[row];
+        entry[0] = time;
+        for (int i = 0; i < size; i++)
+        {
+            entry[1 + i] = z[i];
+        }
+    };
+
+    T i = t0;
+    for (int index = 0; index < x - 1; index++)
+    {
+        record(index, i);
+        Derivative(i, z, k1);
+        Step(i, h);
+
+        // Time is recomputed from the step index, as in RungeKuttaSolver
+        i = t0 + (index + 1) * h;
+    }
+    record(x - 1, i);
+    stats.steps = x - 1;
+}
+
+// Steps as Solve does up to the last requested time and interpolates every
+// component between steps with a cubic Hermite segment. The slope at the end
+// of a step is the first stage of the next, so this costs one evaluation more
+// than stepping alone.
+template <typename T>
+void SensitivitySolver<T>::SolveAt(const T& y0, const T& h, const T& t0, const std::vector<T>& times,
+    const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    for (size_t index = 0; index < times.size(); index++)
+    {
+        if (times[index] < t0 || (index > 0 && times[index] < times[index - 1]))
+        {
+            throw std::runtime_error("Output times must be sorted and not before t0");
+        }
+    }
+
+    const int size = Start(y0, expr);
+    TraceSpan solveSpan("solve");
+
+    // Rows keep their storage when the same times are solved again
+    out.resize(times.size());
+    for (std::vector<T>& row : out)
+    {
+        row.resize(1 + size);
+    }
+    if (times.empty())
+    {
+        return;
+    }
+
+    size_t next = 0;
+    auto record = [&](const T& time, const std::vector<T>& values)
+    {
+        std::vector<T>& entry = out[next++];
+        entry[0] = time;
+        for (int c = 0; c < size; c++)
+        {
+            entry[1 + c] = values[c];
+        }
+    };
+
+    while (next < times.size() && times[next] <= t0)
+    {
+        record(times[next], z);
+    }
+
+    const long long steps = times.back() > t0 ? (long long)std::ceil((times.back() - t0) / h) : 0;
+    Derivative(t0, z, k1);
+    for (long long index = 0; index < steps; index++)
+    {
+        const T start = t0 + T(index) * h;
+        const T end = t0 + T(index + 1) * h;
+        previous = z;
+        previousSlope = k1;
+        Step(start, h);
+        Derivative(end, z, k1);
+
+        while (next < times.size() && times[next] <= end)
+        {
+            for (int c = 0; c < size; c++)
+            {
+                stage[c] = HermiteSegment<T>{ start, previous[c], previousSlope[c], end, z[c], k1[c] }.Value(times[next]);
+            }
+            record(times[next], stage);
+        }
+    }
+    stats.steps = steps;
+}
+
+template class SensitivitySolver<float>;
+template class SensitivitySolver<double>;
+template class SensitivitySolver<long double>;
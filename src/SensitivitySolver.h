@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SensitivityExpression.h"
+#include "SolverStats.h"
+
+// Fixed-step RK4 on the state together with its forward sensitivities
+// s_j = dy/dp_j, which satisfy s_j' = df/dy s_j + df/dp_j, s_j(t0) = 0, and,
+// when enabled, s = dy/dy0 with s' = df/dy s, s(t0) = 1. The sensitivities
+// take the same RK4 stages as the state, so they are the exact derivatives of
+// the discrete solution, and the partial derivatives come from one
+// SensitivityExpression pass per stage instead of a repeated Solve per
+// parameter as finite differences need.
+template <typename T>
+class SensitivitySolver
+{
+public:
+
+    SensitivitySolver();
+
+    // Rows are { t, y, dy/dp_1 .. dy/dp_n } with the parameters in the order
+    // they were first set, then dy/dy0 if enabled; the output holds
+    // ceil((t - t0) / h) + 1 rows
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    // Rows as Solve writes them at the given times only, interpolated within
+    // the steps of size h; times must be sorted and not before t0. Rows
+    // already in out are reused, so repeated calls do not allocate.
+    void SolveAt(const T& y0, const T& h, const T& t0, const std::vector<T>& times,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    // Sets a parameter's value, adding it to the output columns if it is new.
+    // Returns false if the name is not an identifier or is t, y, pi or epsilon.
+    bool SetParameter(const std::string& name, const T& value);
+
+    const std::vector<std::string>& GetParameterNames() const;
+
+    void SetInitialValueSensitivity(bool enabled);
+
+    const SolverStats& GetStats() const;
+
+private:
+
+    void CompileExpression(const std::string& expression_string);
+
+    // Compiles, sets up z at t0 and returns its size
+    int Start(const T& y0, const std::string& expr);
+
+    // z = { y, s_1 .. s_m } and dz = its derivative at time t
+    void Derivative(const T& t, const std::vector<T>& z, std::vector<T>& dz);
+
+    // Advances z from time by h, with k1 already holding its derivative
+    void Step(const T& time, const T& h);
+
+    SensitivityExpression<T> expression;
+    std::vector<std::string> names;
+    std::vector<T> parameterValues;
+    bool initialValue = false;
+
+    std::vector<T> partials;
+    std::vector<T> z;
+    std::vector<T> k1, k2, k3, k4, stage;
+    std::vector<T> previous, previousSlope;
+    SolverStats stats;
+};
@@ -0,0 +1,258 @@
+#include "ShootingSolver.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+template <typename T>
+ShootingSolver<T>::ShootingSolver(int threads) : pool(threads), tolerance(T(1000) * std::numeric_limits<T>::epsilon())
+{
+    for (int worker = 0; worker < pool.GetThreadCount(); worker++)
+    {
+        solvers.push_back(std::make_unique<SensitivitySolver<T>>());
+        solvers.back()->SetInitialValueSensitivity(true);
+    }
+    rows.resize(pool.GetThreadCount());
+}
+
+template <typename T>
+bool ShootingSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return solvers[0]->IsExpressionValid(expression_str);
+}
+
+template <typename T>
+bool ShootingSolver<T>::SetParameter(const std::string& name, const T& value)
+{
+    for (std::unique_ptr<SensitivitySolver<T>>& solver : solvers)
+    {
+        if (!solver->SetParameter(name, value))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void ShootingSolver<T>::SetSegments(int segments)
+{
+    this->segments = std::max(0, segments);
+}
+
+template <typename T>
+void ShootingSolver<T>::SetTolerance(const T& tolerance)
+{
+    this->tolerance = tolerance;
+}
+
+template <typename T>
+void ShootingSolver<T>::SetMaxIterations(int iterations)
+{
+    maxIterations = std::max(1, iterations);
+}
+
+template <typename T>
+const SolverStats& ShootingSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+const ShootingStats<T>& ShootingSolver<T>::GetShootingStats() const
+{
+    return shootingStats;
+}
+
+// Solves matrix d = deltas in place, overwriting both
+template <typename T>
+void ShootingSolver<T>::Eliminate(int size)
+{
+    for (int column = 0; column < size; column++)
+    {
+        int pivot = column;
+        for (int row = column + 1; row < size; row++)
+        {
+            if (std::abs(matrix[size_t(row) * size + column]) > std::abs(matrix[size_t(pivot) * size + column]))
+            {
+                pivot = row;
+            }
+        }
+        const T largest = matrix[size_t(pivot) * size + column];
+        if (largest == T(0) || !std::isfinite(largest))
+        {
+            throw std::runtime_error("Shooting Newton system is singular");
+        }
+        if (pivot != column)
+        {
+            std::swap_ranges(matrix.begin() + size_t(pivot) * size, matrix.begin() + size_t(pivot + 1) * size, matrix.begin() + size_t(column) * size);
+            std::swap(deltas[pivot], deltas[column]);
+        }
+
+        for (int row = column + 1; row < size; row++)
+        {
+            const T factor = matrix[size_t(row) * size + column] / largest;
+            if (factor == T(0))
+            {
+                continue;
+            }
+            for (int c = column; c < size; c++)
+            {
+                matrix[size_t(row) * size + c] -= factor * matrix[size_t(column) * size + c];
+            }
+            deltas[row] -= factor * deltas[column];
+        }
+    }
+
+    for (int row = size - 1; row >= 0; row--)
+    {
+        T sum = deltas[row];
+        for (int c = row + 1; c < size; c++)
+        {
+            sum -= matrix[size_t(row) * size + c] * deltas[c];
+        }
+        deltas[row] = sum / matrix[size_t(row) * size + row];
+    }
+}
+
+template <typename T>
+void ShootingSolver<T>::Solve(const T& guess, const T& h, const T& t, const T& t0, const std::string& expr,
+    const BoundaryCondition<T>& condition, std::vector<std::vector<T>>& out)
+{
+    if (!(t > t0) || !(h > 0))
+    {
+        throw std::runtime_error("Shooting needs t > t0 and h > 0");
+    }
+    for (std::unique_ptr<SensitivitySolver<T>>& solver : solvers)
+    {
+        if (!solver->IsExpressionValid(expr))
+        {
+            throw std::runtime_error("Invalid expression: " + expr);
+        }
+    }
+
+    TraceSpan solveSpan("shooting");
+
+    const int count = segments > 0 ? segments : pool.GetThreadCount();
+    times.resize(count + 1);
+    for (int i = 0; i <= count; i++)
+    {
+        times[i] = t0 + (t - t0) * T(i) / T(count);
+    }
+    times[count] = t;
+    starts.assign(count, guess);
+    ends.resize(count);
+    gains.resize(count);
+    deltas.resize(count);
+    matrix.resize(size_t(count) * count);
+    workerStats.assign(pool.GetThreadCount(), SolverStats());
+
+    // Whole steps per segment so every end value is a step, not an interpolation
+    const long long stepsPerSegment = std::max(1LL, (long long)std::ceil((t - t0) / (T(count) * h)));
+
+    shootingStats = ShootingStats<T>();
+    shootingStats.segments = count;
+
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    for (int iteration = 0; iteration < maxIterations; iteration++)
+    {
+        // One wave: every segment from its current start value
+        pool.ParallelFor(count, [&](int worker, int i)
+            {
+                SensitivitySolver<T>& solver = *solvers[worker];
+                std::vector<std::vector<T>>& endpoint = rows[worker];
+                try
+                {
+                    const T step = (times[i + 1] - times[i]) / T(stepsPerSegment);
+                    solver.SolveAt(starts[i], step, times[i], { times[i + 1] }, expr, endpoint);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                    return;
+                }
+
+                // Rows are { t, y, dy/dp.., dy/dy0 }
+                ends[i] = endpoint[0][1];
+                gains[i] = endpoint[0].back();
+
+                const SolverStats& shotStats = solver.GetStats();
+                SolverStats& total = workerStats[worker];
+                total.steps += shotStats.steps;
+                total.evaluations += shotStats.evaluations;
+            });
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        shootingStats.iterations = iteration + 1;
+        shootingStats.shots += count;
+
+        // Continuity gaps F_i = end_i - start_i+1 and the boundary residual R
+        const T boundary = condition.left * starts[0] + condition.right * ends[count - 1] - condition.value;
+        T residual = std::abs(boundary) / (1 + std::abs(condition.value));
+        for (int i = 0; i + 1 < count; i++)
+        {
+            residual = std::max(residual, std::abs(ends[i] - starts[i + 1]) / (1 + std::abs(ends[i])));
+        }
+        shootingStats.residual = residual;
+        if (residual <= tolerance)
+        {
+            shootingStats.converged = true;
+            break;
+        }
+        if (iteration + 1 == maxIterations)
+        {
+            break;
+        }
+
+        // Newton rows G_i d_i - d_i+1 = -F_i and left d_0 + right G_last d_last = -R.
+        // Condensing them onto d_0 multiplies all the gains together, which
+        // loses the accuracy multiple shooting is for, so the system is solved
+        // whole by elimination with partial pivoting instead
+        std::fill(matrix.begin(), matrix.end(), T(0));
+        for (int i = 0; i + 1 < count; i++)
+        {
+            matrix[size_t(i) * count + i] = gains[i];
+            matrix[size_t(i) * count + i + 1] = T(-1);
+            deltas[i] = starts[i + 1] - ends[i];
+        }
+        matrix[size_t(count - 1) * count] += condition.left;
+        matrix[size_t(count - 1) * count + count - 1] += condition.right * gains[count - 1];
+        deltas[count - 1] = -boundary;
+        Eliminate(count);
+
+        for (int i = 0; i < count; i++)
+        {
+            starts[i] += deltas[i];
+        }
+    }
+
+    out.resize(count + 1);
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = { times[i], starts[i] };
+    }
+    out[count] = { t, ends[count - 1] };
+
+    stats = SolverStats();
+    for (const SolverStats& worker : workerStats)
+    {
+        stats.steps += worker.steps;
+        stats.evaluations += worker.evaluations;
+    }
+}
+
+template class ShootingSolver<float>;
+template class ShootingSolver<double>;
+template class ShootingSolver<long double>;
@@ -0,0 +1,93 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "SensitivitySolver.h"
+#include "SolverStats.h"
+#include "ThreadPool.h"
+
+// left y(t0) + right y(t) = value, the general linear two-point condition
+// for a scalar first-order equation, e.g. { 0, 1, 2 } asks for y(t) = 2
+template <typename T>
+struct BoundaryCondition
+{
+    T left;
+    T right;
+    T value;
+};
+
+// Iteration counts and costs of the last ShootingSolver::Solve
+template <typename T>
+struct ShootingStats
+{
+    int segments = 0;
+    int iterations = 0;
+    bool converged = false;
+    T residual = T(0);
+    long long shots = 0;
+};
+
+// Two-point boundary value problems by multiple shooting. [t0, t] is cut into
+// segments, one per thread by default, and the unknowns are the state at the
+// start of each segment. Every Newton iteration is one ParallelFor wave that
+// shoots all segments at once, each worker with its own SensitivitySolver, and
+// keeps only each segment's end value and its derivative with respect to the
+// start value. The Newton system has one row per segment and is small, so it
+// is solved directly by elimination. With one segment this is single
+// shooting; more segments keep each shot short, which keeps the Newton system
+// well conditioned when the solution is sensitive to its initial value.
+template <typename T>
+class ShootingSolver
+{
+public:
+
+    // 0 threads uses one per hardware thread
+    explicit ShootingSolver(int threads = 0);
+
+    // Finds the solution on [t0, t] that satisfies the condition, starting
+    // every segment from guess, and writes { t_i, y(t_i) } at the segment
+    // boundaries only, so out[0][1] is the initial value to pass to Solve
+    // for the full trajectory. Each segment takes equal fixed RK4 steps of
+    // at most h. Throws std::runtime_error if the Newton system is singular.
+    void Solve(const T& guess, const T& h, const T& t, const T& t0, const std::string& expr,
+        const BoundaryCondition<T>& condition, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    // Named constant the expression can use, see SensitivitySolver::SetParameter
+    bool SetParameter(const std::string& name, const T& value);
+
+    // 0 uses one segment per thread
+    void SetSegments(int segments);
+
+    // Largest continuity or boundary residual, relative to 1 + |y|, that counts as converged
+    void SetTolerance(const T& tolerance);
+
+    void SetMaxIterations(int iterations);
+
+    // Totals over all shots
+    const SolverStats& GetStats() const;
+
+    const ShootingStats<T>& GetShootingStats() const;
+
+private:
+
+    void Eliminate(int size);
+
+    ThreadPool pool;
+    std::vector<std::unique_ptr<SensitivitySolver<T>>> solvers;
+    std::vector<std::vector<std::vector<T>>> rows;
+    std::vector<SolverStats> workerStats;
+
+    // Per segment: boundary time, start value, end value and d(end)/d(start)
+    std::vector<T> times, starts, ends, gains;
+
+    // Newton matrix, row-major, and the right-hand side that becomes the update
+    std::vector<T> matrix, deltas;
+
+    int segments = 0;
+    int maxIterations = 50;
+    T tolerance;
+    SolverStats stats;
+    ShootingStats<T> shootingStats;
+};
@@ -0,0 +1,84 @@
+#include "SimdDispatch.h"
+
+#if SIMD_DISPATCH && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+
+namespace
+{
+    bool HasBit(int value, int bit)
+    {
+        return (value >> bit) & 1;
+    }
+
+    // The CPU must have the instructions and the OS must save the wider
+    // registers on a context switch, which XGETBV reports
+    SimdLevel DetectCpuid()
+    {
+        int info[4];
+        __cpuid(info, 0);
+        const int leaves = info[0];
+        if (leaves < 7)
+        {
+            return SimdLevel::Scalar;
+        }
+
+        __cpuid(info, 1);
+        const bool fma = HasBit(info[2], 12);
+        if (!HasBit(info[2], 27) || !HasBit(info[2], 28))
+        {
+            // No OSXSAVE or no AVX
+            return SimdLevel::Scalar;
+        }
+        const unsigned long long enabled = _xgetbv(0);
+        const bool avxState = (enabled & 0x6) == 0x6;
+        const bool avx512State = (enabled & 0xe6) == 0xe6;
+
+        __cpuidex(info, 7, 0);
+        const bool avx2 = HasBit(info[1], 5);
+        const bool avx512 = HasBit(info[1], 16) && HasBit(info[1], 31);
+
+        if (avx512State && avx512 && avx2 && fma)
+        {
+            return SimdLevel::Avx512;
+        }
+        if (avxState && avx2 && fma)
+        {
+            return SimdLevel::Avx2;
+        }
+        return SimdLevel::Scalar;
+    }
+}
+#endif
+
+SimdLevel DetectSimdLevel()
+{
+#if SIMD_DISPATCH && defined(_MSC_VER)
+    static const SimdLevel level = DetectCpuid();
+    return level;
+#elif SIMD_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl"))
+    {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return SimdLevel::Avx2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
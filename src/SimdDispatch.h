@@ -0,0 +1,40 @@
+#pragma once
+
+// Instruction sets the lane-batched kernels are compiled for. Each kernel is
+// built once per level from the same source, in a source file of its own
+// with the level's target attribute or, under MSVC, that file's /arch, and
+// the one to run is picked at run time from the CPU, so the binary still runs
+// on machines without AVX. The vector code itself is left to the compiler's
+// auto-vectorizer working on fixed-width lane loops.
+enum class SimdLevel
+{
+    Scalar,
+    Avx2,
+    Avx512,
+};
+
+// Per-level builds need x86 and either GCC or Clang target attributes or the
+// per-file /arch settings of the MSVC project; elsewhere only the scalar
+// build exists
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_DISPATCH 1
+#define SIMD_INLINE inline __attribute__((always_inline))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx2,fma")))
+#define SIMD_RESTRICT __restrict__
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SIMD_DISPATCH 1
+#define SIMD_INLINE __forceinline
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#define SIMD_RESTRICT __restrict
+#else
+#define SIMD_DISPATCH 0
+#define SIMD_INLINE inline
+#define SIMD_RESTRICT __restrict
+#endif
+
+// Widest level both compiled in and supported by this CPU
+SimdLevel DetectSimdLevel();
+
+const char* SimdLevelName(SimdLevel level);
@@ -0,0 +1,101 @@
+#include "SlidingWindow.h"
+#include <algorithm>
+#include <stdexcept>
+
+template <typename T>
+SlidingWindow<T>::SlidingWindow(size_t capacity) : times(capacity), values(capacity)
+{
+    if (capacity == 0)
+    {
+        throw std::runtime_error("A sliding window needs room for at least one row");
+    }
+}
+
+template <typename T>
+void SlidingWindow<T>::Add(const T& t, const T& y)
+{
+    times[next] = t;
+    values[next] = y;
+    next = next + 1 == times.size() ? 0 : next + 1;
+    size = std::min(size + 1, times.size());
+
+    WindowAggregates<T>& a = aggregates;
+    if (a.count == 0 || y < a.min)
+    {
+        a.min = y;
+        a.minTime = t;
+    }
+    if (a.count == 0 || y > a.max)
+    {
+        a.max = y;
+        a.maxTime = t;
+    }
+    a.count++;
+    const T delta = y - a.mean;
+    a.mean += delta / T(a.count);
+    a.m2 += delta * (y - a.mean);
+}
+
+template <typename T>
+typename RungeKuttaSolver<T>::RowSink SlidingWindow<T>::Sink()
+{
+    return [this](const std::vector<std::vector<T>>& out, size_t begin, size_t end)
+    {
+        for (size_t row = begin; row < end; row++)
+        {
+            Add(out[row][0], out[row][1]);
+        }
+    };
+}
+
+template <typename T>
+size_t SlidingWindow<T>::Size() const
+{
+    return size;
+}
+
+template <typename T>
+size_t SlidingWindow<T>::Capacity() const
+{
+    return times.size();
+}
+
+template <typename T>
+T SlidingWindow<T>::Time(size_t index) const
+{
+    return times[(next + times.size() - size + index) % times.size()];
+}
+
+template <typename T>
+T SlidingWindow<T>::Value(size_t index) const
+{
+    return values[(next + times.size() - size + index) % times.size()];
+}
+
+template <typename T>
+void SlidingWindow<T>::CopyTo(std::vector<std::vector<T>>& out) const
+{
+    out.resize(size);
+    for (size_t index = 0; index < size; index++)
+    {
+        out[index] = { Time(index), Value(index) };
+    }
+}
+
+template <typename T>
+const WindowAggregates<T>& SlidingWindow<T>::GetAggregates() const
+{
+    return aggregates;
+}
+
+template <typename T>
+void SlidingWindow<T>::Clear()
+{
+    next = 0;
+    size = 0;
+    aggregates = WindowAggregates<T>();
+}
+
+template class SlidingWindow<float>;
+template class SlidingWindow<double>;
+template class SlidingWindow<long double>;
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include "RungeKuttaSolver.h"
+
+// Aggregates of y over every row a SlidingWindow has seen, updated per row.
+// The mean and variance use Welford's update, which stays accurate over long
+// runs where summing y and y^2 would cancel.
+template <typename T>
+struct WindowAggregates
+{
+    long long count = 0;
+    T min = T(0);
+    T minTime = T(0);
+    T max = T(0);
+    T maxTime = T(0);
+    T mean = T(0);
+
+    // Sum of squared differences from the mean
+    T m2 = T(0);
+
+    T Variance() const
+    {
+        return count > 1 ? m2 / T(count - 1) : T(0);
+    }
+};
+
+// Keeps the last capacity (t, y) rows of a run in a ring buffer allocated
+// once, plus aggregates over the whole run, so a long run can be monitored in
+// constant memory. Feed it from RungeKuttaSolver::SetStreaming with Sink().
+template <typename T>
+class SlidingWindow
+{
+public:
+
+    // Throws std::runtime_error if capacity is 0
+    explicit SlidingWindow(size_t capacity);
+
+    void Add(const T& t, const T& y);
+
+    // Adds each row the solver hands out; the window must outlive the solve
+    typename RungeKuttaSolver<T>::RowSink Sink();
+
+    size_t Size() const;
+
+    size_t Capacity() const;
+
+    // Row index of the window, oldest first
+    T Time(size_t index) const;
+
+    T Value(size_t index) const;
+
+    // Window rows oldest first, as RungeKuttaSolver::Solve writes them
+    void CopyTo(std::vector<std::vector<T>>& out) const;
+
+    const WindowAggregates<T>& GetAggregates() const;
+
+    void Clear();
+
+private:
+
+    std::vector<T> times;
+    std::vector<T> values;
+    size_t next = 0;
+    size_t size = 0;
+    WindowAggregates<T> aggregates;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+// Work counters reported by the solvers for the last Solve call
+struct SolverStats
+{
+    long long steps = 0;
+    long long rejectedSteps = 0;
+    long long evaluations = 0;
+    long long jacobianEvaluations = 0;
+    long long factorizations = 0;
+};
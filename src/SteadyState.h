@@ -0,0 +1,73 @@
+#pragma once
+#include <cmath>
+
+// What happens to the output after the solution settles: Fill keeps the
+// requested rows and repeats the steady value in them, Truncate ends the
+// output at the step where the steady state was detected
+enum class SteadyStateOutput
+{
+    Fill,
+    Truncate,
+};
+
+template <typename T>
+struct SteadyStateOptions
+{
+    bool enabled = false;
+    T derivativeTolerance = T(1e-8);
+    T changeTolerance = T(1e-8);
+    int window = 10;
+    SteadyStateOutput output = SteadyStateOutput::Fill;
+};
+
+// Where integration stopped early and how much of it was skipped. For
+// adaptive steps stepsSkipped is estimated from the last step size.
+template <typename T>
+struct SteadyStateStats
+{
+    bool reached = false;
+    T time = T(0);
+    T skippedTime = T(0);
+    long long stepsSkipped = 0;
+};
+
+// Opt-in convergence monitor: the solution is steady once |f(t, y)| and the
+// change in y over a step have both been within tolerance for a window of
+// consecutive steps
+template <typename T>
+class SteadyStateMonitor
+{
+public:
+
+    void Configure(const SteadyStateOptions<T>& options)
+    {
+        this->options = options;
+    }
+
+    const SteadyStateOptions<T>& GetOptions() const
+    {
+        return options;
+    }
+
+    void Start()
+    {
+        settledSteps = 0;
+    }
+
+    // Records an accepted step with slope f at its start and change dy
+    bool Settled(const T& f, const T& dy)
+    {
+        if (!options.enabled)
+        {
+            return false;
+        }
+        const bool quiet = std::fabs(f) <= options.derivativeTolerance && std::fabs(dy) <= options.changeTolerance;
+        settledSteps = quiet ? settledSteps + 1 : 0;
+        return settledSteps >= options.window;
+    }
+
+private:
+
+    SteadyStateOptions<T> options;
+    int settledSteps = 0;
+};
@@ -0,0 +1,242 @@
+#include "SweepEngine.h"
+#include "ColumnarFile.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+    const char* InitialValueAxis = "y0";
+}
+
+template <typename T>
+SweepEngine<T>::SweepEngine(int threads) : pool(threads)
+{
+    // The sinks point into summaries, so it is sized once here
+    batches.resize(pool.GetThreadCount());
+    summaries.assign(pool.GetThreadCount(), TrajectorySummary<T>(ReduceExtrema | ReduceFinal));
+    for (int worker = 0; worker < pool.GetThreadCount(); worker++)
+    {
+        solvers.push_back(std::make_unique<RungeKuttaSolver<T>>());
+        solvers.back()->SetStreaming(BatchRows, summaries[worker].Sink());
+    }
+}
+
+template <typename T>
+void SweepEngine<T>::AddAxis(const SweepAxis<T>& axis)
+{
+    if (axis.count < 1)
+    {
+        throw std::runtime_error("Sweep axis " + axis.name + " needs at least one value");
+    }
+    axes.push_back(axis);
+}
+
+template <typename T>
+void SweepEngine<T>::ClearAxes()
+{
+    axes.clear();
+}
+
+template <typename T>
+bool SweepEngine<T>::SetParameter(const std::string& name, const T& value)
+{
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        if (!solver->SetParameter(name, value))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool SweepEngine<T>::AddEvent(const std::string& expression, EventAction action)
+{
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        if (!solver->AddEvent(expression, action))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void SweepEngine<T>::SetMethod(Method method)
+{
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        solver->SetMethod(method);
+    }
+}
+
+template <typename T>
+void SweepEngine<T>::SetTolerance(const T& tolerance)
+{
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        solver->SetTolerance(tolerance);
+    }
+}
+
+template <typename T>
+void SweepEngine<T>::SetGroupSize(int points)
+{
+    groupSize = std::max(1, points);
+}
+
+template <typename T>
+long long SweepEngine<T>::GetPointCount() const
+{
+    long long count = 1;
+    for (const SweepAxis<T>& axis : axes)
+    {
+        count *= axis.count;
+    }
+    return count;
+}
+
+template <typename T>
+const SolverStats& SweepEngine<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+void SweepEngine<T>::Run(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr, const std::string& path)
+{
+    // Every parameter axis is bound before compiling so the expression can use it
+    for (std::unique_ptr<RungeKuttaSolver<T>>& solver : solvers)
+    {
+        for (const SweepAxis<T>& axis : axes)
+        {
+            if (axis.name != InitialValueAxis && !solver->SetParameter(axis.name, axis.first))
+            {
+                throw std::runtime_error("Invalid parameter name: " + axis.name);
+            }
+        }
+        if (!solver->IsExpressionValid(expr))
+        {
+            throw std::runtime_error("Invalid expression: " + expr);
+        }
+    }
+
+    TraceSpan sweepSpan("sweep");
+
+    std::vector<std::string> names = { "point" };
+    for (const SweepAxis<T>& axis : axes)
+    {
+        names.push_back(axis.name);
+    }
+    names.insert(names.end(), { "final", "min", "max", "event_t" });
+    ColumnarWriter writer(path, names);
+
+    const long long points = GetPointCount();
+    columns.assign(names.size(), std::vector<double>(size_t(std::min<long long>(groupSize, points))));
+    workerStats.assign(pool.GetThreadCount(), SolverStats());
+
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    for (long long first = 0; first < points; first += groupSize)
+    {
+        const int rows = int(std::min<long long>(groupSize, points - first));
+        pool.ParallelFor(rows, [&](int worker, int row)
+            {
+                try
+                {
+                    SolvePoint(worker, first + row, row, y0, h, t, t0, expr);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            });
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        writer.WriteGroup(columns, rows);
+    }
+
+    stats = SolverStats();
+    for (const SolverStats& worker : workerStats)
+    {
+        stats.steps += worker.steps;
+        stats.rejectedSteps += worker.rejectedSteps;
+        stats.evaluations += worker.evaluations;
+    }
+}
+
+template <typename T>
+void SweepEngine<T>::SolvePoint(int worker, long long point, size_t row, const T& y0, const T& h, const T& t, const T& t0,
+    const std::string& expr)
+{
+    RungeKuttaSolver<T>& solver = *solvers[worker];
+
+    // Decode the point number, last axis fastest
+    T start = y0;
+    long long rest = point;
+    for (size_t a = axes.size(); a-- > 0;)
+    {
+        const SweepAxis<T>& axis = axes[a];
+        const T value = axis.Value(int(rest % axis.count));
+        rest /= axis.count;
+        columns[1 + a][row] = double(value);
+        if (axis.name == InitialValueAxis)
+        {
+            start = value;
+        }
+        else
+        {
+            solver.SetParameter(axis.name, value);
+        }
+    }
+
+    // Rows are reduced as the solver hands them out; an empty interval
+    // produces none and leaves the solver's events from the previous point
+    TrajectorySummary<T>& summary = summaries[worker];
+    summary.Clear();
+    if (t0 < t)
+    {
+        solver.Solve(start, h, t, t0, expr, batches[worker]);
+    }
+
+    const SummaryValues<T>& values = summary.GetValues();
+    T final = start, low = start, high = start;
+    if (values.rows > 0)
+    {
+        final = values.finalValue;
+        low = std::min(low, values.min);
+        high = std::max(high, values.max);
+    }
+
+    const std::vector<EventRecord<T>>& events = solver.GetEvents();
+    const size_t column = 1 + axes.size();
+    columns[0][row] = double(point);
+    columns[column][row] = double(final);
+    columns[column + 1][row] = double(low);
+    columns[column + 2][row] = double(high);
+    columns[column + 3][row] = events.empty() || values.rows == 0 ? std::numeric_limits<double>::quiet_NaN() : double(events.front().t);
+
+    const SolverStats& pointStats = solver.GetStats();
+    SolverStats& total = workerStats[worker];
+    total.steps += pointStats.steps;
+    total.rejectedSteps += pointStats.rejectedSteps;
+    total.evaluations += pointStats.evaluations;
+}
+
+template class SweepEngine<float>;
+template class SweepEngine<double>;
+template class SweepEngine<long double>;
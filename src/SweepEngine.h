@@ -0,0 +1,93 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "ButcherTableau.h"
+#include "EventSet.h"
+#include "RungeKuttaSolver.h"
+#include "SolverStats.h"
+#include "ThreadPool.h"
+#include "TrajectorySummary.h"
+
+// count evenly spaced values from first to last of one swept quantity. The
+// name y0 sweeps the initial value; any other name is an expression parameter.
+template <typename T>
+struct SweepAxis
+{
+    std::string name;
+    T first;
+    T last;
+    int count;
+
+    T Value(int index) const
+    {
+        return count > 1 ? first + (last - first) * T(index) / T(count - 1) : first;
+    }
+};
+
+// Cartesian parameter sweep. Grid points are numbered with the last axis
+// varying fastest and decoded from their number when they are run, so the
+// grid itself is never stored. Points are solved in groups on a ThreadPool,
+// each worker with its own RungeKuttaSolver and so its own compiled
+// expression and parameter values, and each group's summaries are appended
+// to a columnar file before the next group starts. Each worker's solver
+// streams its rows in small batches into a TrajectorySummary, so no
+// trajectory is ever stored and memory grows with neither the number of
+// points nor the number of steps.
+//
+// Columns: point, one per axis, then final, min and max of y, and event_t,
+// the time of the first event (NaN if none fired).
+template <typename T>
+class SweepEngine
+{
+public:
+
+    // Rows a worker holds at once while its solver streams them
+    static constexpr size_t BatchRows = 256;
+
+    // 0 threads uses one per hardware thread
+    explicit SweepEngine(int threads = 0);
+
+    // Throws std::runtime_error if count is below 1
+    void AddAxis(const SweepAxis<T>& axis);
+
+    void ClearAxes();
+
+    // Fixed value for a parameter that is not swept
+    bool SetParameter(const std::string& name, const T& value);
+
+    // The first event that fires gives event_t; a terminal event also ends
+    // the run, so final is the value there
+    bool AddEvent(const std::string& expression, EventAction action);
+
+    void SetMethod(Method method);
+
+    void SetTolerance(const T& tolerance);
+
+    // Points solved between writes to the file
+    void SetGroupSize(int points);
+
+    long long GetPointCount() const;
+
+    // Solves every grid point from y0 (unless y0 is an axis) with step h over
+    // [t0, t] and writes one row per point to path
+    void Run(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr, const std::string& path);
+
+    // Totals over all points of the last Run
+    const SolverStats& GetStats() const;
+
+private:
+
+    void SolvePoint(int worker, long long point, size_t row, const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr);
+
+    ThreadPool pool;
+    std::vector<std::unique_ptr<RungeKuttaSolver<T>>> solvers;
+    std::vector<std::vector<std::vector<T>>> batches;
+    std::vector<TrajectorySummary<T>> summaries;
+    std::vector<SolverStats> workerStats;
+    std::vector<SweepAxis<T>> axes;
+    std::vector<std::vector<double>> columns;
+    int groupSize = 4096;
+    SolverStats stats;
+};
@@ -0,0 +1,236 @@
+#include "TaylorExpression.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+
+template <typename T>
+TaylorExpression<T>::TaylorExpression()
+{
+}
+
+template <typename T>
+bool TaylorExpression<T>::Compile(const std::string& expression)
+{
+    if (compiled && source == expression)
+    {
+        return true;
+    }
+
+    TraceSpan span("compile");
+
+    compiled = tape.Compile(expression);
+    source = compiled ? expression : std::string();
+    stride = 0;
+    return compiled;
+}
+
+template <typename T>
+bool TaylorExpression<T>::IsCompiled() const
+{
+    return compiled;
+}
+
+template <typename T>
+const std::string& TaylorExpression<T>::GetExpression() const
+{
+    return source;
+}
+
+template <typename T>
+void TaylorExpression<T>::SolutionCoefficients(const T& t, const T& y, int order, std::vector<T>& series)
+{
+    if (stride < order + 1)
+    {
+        stride = order + 1;
+        coefficients.assign(tape.GetNodes().size() * stride, T(0));
+        companions.assign(tape.GetNodes().size() * stride, T(0));
+    }
+
+    series.assign(order + 1, T(0));
+    series[0] = y;
+    time = t;
+    state = &series;
+
+    // y' = f(t, y) gives y_k+1 = f_k / (k + 1), and f_k only needs y_0 .. y_k
+    const int nodes = int(tape.GetNodes().size());
+    for (int k = 0; k < order; k++)
+    {
+        for (int n = 0; n < nodes; n++)
+        {
+            Propagate(n, k);
+        }
+        series[k + 1] = Coefficient(tape.GetRoot(), k) / (k + 1);
+    }
+}
+
+// The recurrences follow from differentiating each operation as a power
+// series, e.g. c = exp(a) satisfies c' = a' c, so k c_k = sum j a_j c_k-j.
+template <typename T>
+void TaylorExpression<T>::Propagate(int n, int k)
+{
+    const Node& node = tape.GetNodes()[n];
+    T* c = &Coefficient(n, 0);
+    T* s = &Companion(n, 0);
+    const T* a = node.left >= 0 ? &Coefficient(node.left, 0) : nullptr;
+    const T* b = node.right >= 0 ? &Coefficient(node.right, 0) : nullptr;
+
+    // sum j a_j z_k-j for j = 1 .. k, divided by k
+    auto chain = [&](const T* z)
+    {
+        T sum = T(0);
+        for (int j = 1; j <= k; j++)
+        {
+            sum += j * a[j] * z[k - j];
+        }
+        return sum / k;
+    };
+
+    switch (node.op)
+    {
+    case Op::Constant:
+        c[k] = k == 0 ? node.value : T(0);
+        break;
+    case Op::Time:
+        c[k] = k == 0 ? time : k == 1 ? T(1) : T(0);
+        break;
+    case Op::State:
+        c[k] = (*state)[k];
+        break;
+    case Op::Parameter:
+        // Not reached, the tape is compiled without parameter names
+        break;
+    case Op::Add:
+        c[k] = a[k] + b[k];
+        break;
+    case Op::Subtract:
+        c[k] = a[k] - b[k];
+        break;
+    case Op::Negate:
+        c[k] = -a[k];
+        break;
+    case Op::Multiply:
+    {
+        T sum = T(0);
+        for (int j = 0; j <= k; j++)
+        {
+            sum += a[j] * b[k - j];
+        }
+        c[k] = sum;
+        break;
+    }
+    case Op::Divide:
+    {
+        T sum = a[k];
+        for (int j = 0; j < k; j++)
+        {
+            sum -= c[j] * b[k - j];
+        }
+        c[k] = sum / b[0];
+        break;
+    }
+    case Op::Exp:
+        c[k] = k == 0 ? std::exp(a[0]) : chain(c);
+        break;
+    case Op::Log:
+    {
+        if (k == 0)
+        {
+            c[0] = std::log(a[0]);
+            break;
+        }
+        T sum = T(0);
+        for (int j = 1; j < k; j++)
+        {
+            sum += j * c[j] * a[k - j];
+        }
+        c[k] = (a[k] - sum / k) / a[0];
+        break;
+    }
+    case Op::Sqrt:
+    {
+        if (k == 0)
+        {
+            c[0] = std::sqrt(a[0]);
+            break;
+        }
+        T sum = T(0);
+        for (int j = 1; j < k; j++)
+        {
+            sum += c[j] * c[k - j];
+        }
+        c[k] = (a[k] - sum) / (2 * c[0]);
+        break;
+    }
+    case Op::Sin:
+    case Op::Cos:
+    {
+        // The pair (sin a, cos a) is carried as (c, s) for sin and (s, c) for cos
+        T* sine = node.op == Op::Sin ? c : s;
+        T* cosine = node.op == Op::Sin ? s : c;
+        if (k == 0)
+        {
+            sine[0] = std::sin(a[0]);
+            cosine[0] = std::cos(a[0]);
+            break;
+        }
+        const T nextSine = chain(cosine);
+        cosine[k] = -chain(sine);
+        sine[k] = nextSine;
+        break;
+    }
+    case Op::Sinh:
+    case Op::Cosh:
+    {
+        T* sine = node.op == Op::Sinh ? c : s;
+        T* cosine = node.op == Op::Sinh ? s : c;
+        if (k == 0)
+        {
+            sine[0] = std::sinh(a[0]);
+            cosine[0] = std::cosh(a[0]);
+            break;
+        }
+        const T nextSine = chain(cosine);
+        cosine[k] = chain(sine);
+        sine[k] = nextSine;
+        break;
+    }
+    case Op::Tan:
+    {
+        // tan' = a' (1 + tan^2), with 1 + tan^2 as the companion
+        if (k == 0)
+        {
+            c[0] = std::tan(a[0]);
+            s[0] = 1 + c[0] * c[0];
+            break;
+        }
+        c[k] = chain(s);
+        T sum = T(0);
+        for (int j = 0; j <= k; j++)
+        {
+            sum += c[j] * c[k - j];
+        }
+        s[k] = sum;
+        break;
+    }
+    case Op::Power:
+    {
+        // c = a^r satisfies a c' = r a' c
+        if (k == 0)
+        {
+            c[0] = std::pow(a[0], node.value);
+            break;
+        }
+        T sum = T(0);
+        for (int j = 0; j < k; j++)
+        {
+            sum += (node.value * (k - j) - j) * a[k - j] * c[j];
+        }
+        c[k] = sum / (k * a[0]);
+        break;
+    }
+    }
+}
+
+template class TaylorExpression<float>;
+template class TaylorExpression<double>;
+template class TaylorExpression<long double>;
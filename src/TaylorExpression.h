@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "ExpressionTape.h"
+
+// Right-hand side f(t, y) compiled for Taylor mode automatic differentiation.
+// The expression is parsed into an ExpressionTape, so that a single pass over
+// the tape per order gives the next Taylor coefficient of every node from the
+// standard recurrences.
+template <typename T>
+class TaylorExpression
+{
+public:
+
+    TaylorExpression();
+
+    // Returns false and leaves nothing compiled if the expression is invalid
+    // or uses an operator without a Taylor recurrence here.
+    // Recompiling the expression that is already compiled is a no-op.
+    bool Compile(const std::string& expression);
+
+    bool IsCompiled() const;
+
+    const std::string& GetExpression() const;
+
+    // Normalised Taylor coefficients y_k = y^(k)(t) / k!, k = 0 .. order, of
+    // the solution of y' = f(t, y) through (t, y). Each order is one pass
+    // over the tape and uses the coefficients found by the previous passes.
+    void SolutionCoefficients(const T& t, const T& y, int order, std::vector<T>& series);
+
+private:
+
+    typedef typename ExpressionTape<T>::Op Op;
+    typedef typename ExpressionTape<T>::Node Node;
+
+    // Coefficient k of node n, given coefficients 0 .. k of its operands
+    void Propagate(int n, int k);
+
+    T& Coefficient(int n, int k)
+    {
+        return coefficients[size_t(n) * stride + k];
+    }
+
+    // Companion series: cos for sin, sin for cos, 1 + tan^2 for tan,
+    // cosh for sinh and sinh for cosh
+    T& Companion(int n, int k)
+    {
+        return companions[size_t(n) * stride + k];
+    }
+
+    ExpressionTape<T> tape;
+    std::string source;
+    bool compiled = false;
+
+    T time = T(0);
+    int stride = 0;
+    std::vector<T> coefficients;
+    std::vector<T> companions;
+    const std::vector<T>* state = nullptr;
+};
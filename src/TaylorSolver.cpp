@@ -0,0 +1,110 @@
+#include "TaylorSolver.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+template <typename T>
+TaylorSolver<T>::TaylorSolver()
+{
+}
+
+template <typename T>
+bool TaylorSolver<T>::IsExpressionValid(const std::string& expression_str)
+{
+    return expression.Compile(expression_str);
+}
+
+template <typename T>
+void TaylorSolver<T>::SetTolerances(const T& relative, const T& absolute)
+{
+    relativeTolerance = relative;
+    absoluteTolerance = absolute;
+}
+
+template <typename T>
+const SolverStats& TaylorSolver<T>::GetStats() const
+{
+    return stats;
+}
+
+template <typename T>
+int TaylorSolver<T>::GetMaxOrderUsed() const
+{
+    return maxOrderUsed;
+}
+
+template <typename T>
+void TaylorSolver<T>::Solve(const T& y0, const T& h, const T& t, const T& t0, const std::string& expr, std::vector<std::vector<T>>& out)
+{
+    if (t0 >= t)
+    {
+        return;
+    }
+
+    if (!expression.Compile(expr))
+    {
+        throw std::runtime_error("Invalid expression: " + expr);
+    }
+    stats = SolverStats();
+    maxOrderUsed = 0;
+
+    TraceSpan solveSpan("solve");
+
+    const T minStep = 16 * std::numeric_limits<T>::epsilon();
+
+    T w = y0;
+    T i = t0;
+
+    out.clear();
+    out.push_back({ i, w });
+
+    while (i < t)
+    {
+        const T tolerance = absoluteTolerance + relativeTolerance * std::fabs(w);
+        const int order = std::max(MinOrder, std::min(MaxOrder, int(std::ceil(-std::log(tolerance) / 2 + 1))));
+        expression.SolutionCoefficients(i, w, order, series);
+        stats.evaluations += order;
+        maxOrderUsed = std::max(maxOrderUsed, order);
+
+        if (!std::isfinite(series[order - 1]) || !std::isfinite(series[order]))
+        {
+            throw std::runtime_error("Non-finite Taylor coefficients at t = " + std::to_string(double(i)));
+        }
+
+        // The last two non-zero terms stay below the tolerance over the step;
+        // the safety factor accounts for the remainder of the series. Series
+        // such as that of (y - 1)^3 have runs of zero coefficients, which say
+        // nothing about the radius of convergence and are skipped.
+        T step = std::min(h, t - i);
+        for (int k = order, used = 0; k >= 1 && used < 2; k--)
+        {
+            if (series[k] != 0)
+            {
+                step = std::min(step, std::pow(tolerance / std::fabs(series[k]), T(1) / k) * std::exp(T(-0.7) / (order - 1)));
+                used++;
+            }
+        }
+
+        if (step <= minStep * std::max(T(1), std::fabs(i)))
+        {
+            throw std::runtime_error("Step size underflow in Taylor integration");
+        }
+
+        T next = series[order];
+        for (int k = order - 1; k >= 0; k--)
+        {
+            next = next * step + series[k];
+        }
+
+        i = t - i <= step ? t : i + step;
+        w = next;
+        out.push_back({ i, w });
+        stats.steps++;
+    }
+}
+
+template class TaylorSolver<float>;
+template class TaylorSolver<double>;
+template class TaylorSolver<long double>;
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SolverStats.h"
+#include "TaylorExpression.h"
+
+// Taylor series integrator with the order and step size of Jorba and Zou.
+// The order follows the tolerance, p = -ln(tol) / 2 + 1, and is re-chosen
+// every step since the tolerance is relative to |y|. The step is taken from
+// the radius of convergence estimated from the last two coefficients, so
+// steps are never rejected. Each order of the expansion is one pass over the
+// expression's tape and counts as one evaluation.
+template <typename T>
+class TaylorSolver
+{
+public:
+
+    TaylorSolver();
+
+    // h is the largest step to take; the output holds every step
+    void Solve(const T& y0, const T& h, const T& t, const T& t0,
+        const std::string& expr, std::vector<std::vector<T>>& out);
+
+    bool IsExpressionValid(const std::string& expression_str);
+
+    void SetTolerances(const T& relative, const T& absolute);
+
+    const SolverStats& GetStats() const;
+
+    // Highest order used by the last Solve
+    int GetMaxOrderUsed() const;
+
+private:
+
+    static const int MinOrder = 2;
+    static const int MaxOrder = 40;
+
+    TaylorExpression<T> expression;
+    T relativeTolerance = T(1e-6);
+    T absoluteTolerance = T(1e-6);
+    SolverStats stats;
+    int maxOrderUsed = 0;
+
+    std::vector<T> series;
+};
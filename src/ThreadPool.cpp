@@ -0,0 +1,34 @@
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+ThreadPool::ThreadPool(int threads) : group(threads, [this](int worker) { RunTasks(worker); })
+{
+}
+
+int ThreadPool::GetThreadCount() const
+{
+    return group.GetThreadCount();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int, int)>& task)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    this->task = &task;
+    this->count = count;
+    next.store(0, std::memory_order_relaxed);
+    group.Run();
+    this->task = nullptr;
+}
+
+void ThreadPool::RunTasks(int worker)
+{
+    TraceSpan span("tasks");
+    for (int index = next.fetch_add(1, std::memory_order_relaxed); index < count; index = next.fetch_add(1, std::memory_order_relaxed))
+    {
+        (*task)(worker, index);
+    }
+}
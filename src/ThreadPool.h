@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include "WorkerGroup.h"
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// takes part as worker 0, so a pool of one thread runs everything inline.
+// Indices are handed out one at a time from a shared counter, so uneven
+// iterations still balance. Worker ids let callers keep per-thread state such
+// as a compiled expression, which cannot be shared between threads. If a task
+// throws, ParallelFor rethrows the first exception once every worker is done.
+class ThreadPool
+{
+public:
+
+    // 0 uses one thread per hardware thread
+    explicit ThreadPool(int threads = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int GetThreadCount() const;
+
+    // Runs task(worker, index) for every index in [0, count) and returns once
+    // all have finished; worker is in [0, GetThreadCount())
+    void ParallelFor(int count, const std::function<void(int, int)>& task);
+
+private:
+
+    void RunTasks(int worker);
+
+    const std::function<void(int, int)>* task = nullptr;
+    int count = 0;
+    std::atomic<int> next{ 0 };
+
+    // Last, so its threads start after and are joined before the rest
+    WorkerGroup group;
+};
@@ -0,0 +1,114 @@
+#include "Tracer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct TraceEvent
+    {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+    };
+
+    // Only the owning thread appends to its buffer, so recording needs no lock.
+    // The registry mutex is taken once per thread, when the buffer is created.
+    struct ThreadTraceBuffer
+    {
+        int threadId;
+        std::vector<TraceEvent> events;
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadTraceBuffer>> registry;
+    std::string outputPath;
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    thread_local ThreadTraceBuffer* localBuffer = nullptr;
+
+    ThreadTraceBuffer* GetLocalBuffer()
+    {
+        if (localBuffer == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(std::make_unique<ThreadTraceBuffer>());
+            localBuffer = registry.back().get();
+            localBuffer->threadId = int(registry.size());
+            localBuffer->events.reserve(4096);
+        }
+        return localBuffer;
+    }
+
+    // Writes a nanosecond count as microseconds, the unit trace_event expects
+    void WriteMicroseconds(std::ofstream& out, int64_t ns)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", (long long)(ns / 1000), (long long)(ns % 1000));
+        out << buffer;
+    }
+}
+
+std::atomic<bool> Tracer::enabled(false);
+
+// Starts recording; the trace is written to path when the program exits
+void Tracer::Enable(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (outputPath.empty())
+    {
+        std::atexit(Tracer::Dump);
+    }
+    outputPath = path;
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+// Nanoseconds since program start
+int64_t Tracer::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Tracer::Record(const char* name, int64_t begin, int64_t end)
+{
+    GetLocalBuffer()->events.push_back({ name, begin, end });
+}
+
+// Writes all recorded spans. Worker threads must have been joined beforehand.
+void Tracer::Dump()
+{
+    enabled.store(false, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::ofstream outFile(outputPath);
+    if (!outFile.is_open())
+    {
+        std::cerr << "Unable to open trace file " << outputPath << "\n";
+        return;
+    }
+
+    outFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer : registry)
+    {
+        outFile << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"args\":{\"name\":\"thread " << buffer->threadId << "\"}}";
+        first = false;
+
+        for (const TraceEvent& event : buffer->events)
+        {
+            outFile << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"rk4\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            WriteMicroseconds(outFile, event.begin);
+            outFile << ",\"dur\":";
+            WriteMicroseconds(outFile, event.end - event.begin);
+            outFile << "}";
+        }
+        buffer->events.clear();
+    }
+    outFile << "\n]}\n";
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Records timeline spans per thread and writes them as Chrome trace_event JSON
+// (chrome://tracing, Perfetto) when the program exits. Spans are only recorded
+// after Enable has been called, so a disabled tracer costs one relaxed load.
+class Tracer
+{
+public:
+
+    static void Enable(const std::string& path);
+
+    static bool IsEnabled()
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    static int64_t Now();
+
+    static void Record(const char* name, int64_t begin, int64_t end);
+
+    static void Dump();
+
+private:
+
+    static std::atomic<bool> enabled;
+};
+
+// Scoped span, e.g. TraceSpan span("solve"). The name must be a string literal
+// or otherwise outlive the tracer.
+class TraceSpan
+{
+public:
+
+    explicit TraceSpan(const char* name)
+        : name(name), begin(Tracer::IsEnabled() ? Tracer::Now() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (begin >= 0)
+        {
+            Tracer::Record(name, begin, Tracer::Now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+
+    const char* name;
+    int64_t begin;
+};
@@ -0,0 +1,132 @@
+#include "TrajectorySummary.h"
+#include <sstream>
+
+bool ParseReductions(const std::string& list, int& reductions)
+{
+    reductions = 0;
+    std::stringstream names(list);
+    std::string name;
+    while (std::getline(names, name, ','))
+    {
+        if (name == "extrema")
+        {
+            reductions |= ReduceExtrema;
+        }
+        else if (name == "integral")
+        {
+            reductions |= ReduceIntegral;
+        }
+        else if (name == "crossings")
+        {
+            reductions |= ReduceCrossings;
+        }
+        else if (name == "final")
+        {
+            reductions |= ReduceFinal;
+        }
+        else if (name == "all")
+        {
+            reductions |= ReduceAll;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return reductions != 0;
+}
+
+template <typename T>
+TrajectorySummary<T>::TrajectorySummary(int reductions) : reductions(reductions)
+{
+}
+
+template <typename T>
+void TrajectorySummary<T>::Add(const T& t, const T& y)
+{
+    SummaryValues<T>& v = values;
+    const bool first = v.rows == 0;
+
+    if (reductions & ReduceExtrema)
+    {
+        if (first || y < v.min)
+        {
+            v.min = y;
+            v.minTime = t;
+        }
+        if (first || y > v.max)
+        {
+            v.max = y;
+            v.maxTime = t;
+        }
+    }
+
+    if ((reductions & ReduceIntegral) && !first)
+    {
+        v.integral += (t - previousTime) * (previousValue + y) / 2;
+    }
+
+    if ((reductions & ReduceCrossings) && y != T(0))
+    {
+        if (lastSign != T(0) && (lastSign < 0) != (y < 0))
+        {
+            // Between the last nonzero row and this one; a zero row in
+            // between is where the line from it meets zero anyway
+            const T crossing = previousValue == T(0) ? previousTime : previousTime - previousValue * (t - previousTime) / (y - previousValue);
+            if (v.crossings == 0)
+            {
+                v.firstCrossing = crossing;
+            }
+            v.lastCrossing = crossing;
+            v.crossings++;
+        }
+        lastSign = y;
+    }
+
+    if (reductions & ReduceFinal)
+    {
+        v.finalTime = t;
+        v.finalValue = y;
+    }
+
+    previousTime = t;
+    previousValue = y;
+    v.rows++;
+}
+
+template <typename T>
+typename RungeKuttaSolver<T>::RowSink TrajectorySummary<T>::Sink()
+{
+    return [this](const std::vector<std::vector<T>>& out, size_t begin, size_t end)
+    {
+        for (size_t row = begin; row < end; row++)
+        {
+            Add(out[row][0], out[row][1]);
+        }
+    };
+}
+
+template <typename T>
+int TrajectorySummary<T>::GetReductions() const
+{
+    return reductions;
+}
+
+template <typename T>
+const SummaryValues<T>& TrajectorySummary<T>::GetValues() const
+{
+    return values;
+}
+
+template <typename T>
+void TrajectorySummary<T>::Clear()
+{
+    previousTime = T(0);
+    previousValue = T(0);
+    lastSign = T(0);
+    values = SummaryValues<T>();
+}
+
+template class TrajectorySummary<float>;
+template class TrajectorySummary<double>;
+template class TrajectorySummary<long double>;
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "RungeKuttaSolver.h"
+
+// Reductions a TrajectorySummary computes, combined as flags
+enum Reduction
+{
+    ReduceExtrema = 1,
+    ReduceIntegral = 2,
+    ReduceCrossings = 4,
+    ReduceFinal = 8,
+    ReduceAll = ReduceExtrema | ReduceIntegral | ReduceCrossings | ReduceFinal,
+};
+
+// Parses a comma-separated list of extrema, integral, crossings and final, or
+// all. Returns false on an unknown name.
+bool ParseReductions(const std::string& list, int& reductions);
+
+// Results of the selected reductions; the others stay at zero
+template <typename T>
+struct SummaryValues
+{
+    long long rows = 0;
+    T min = T(0);
+    T minTime = T(0);
+    T max = T(0);
+    T maxTime = T(0);
+
+    // Trapezoid rule over the rows, so exact for the piecewise linear path
+    // through them
+    T integral = T(0);
+
+    // Strict sign changes of y between rows, located by linear interpolation
+    long long crossings = 0;
+    T firstCrossing = T(0);
+    T lastCrossing = T(0);
+
+    T finalTime = T(0);
+    T finalValue = T(0);
+};
+
+// Reduces a run row by row as the solver hands the rows out, keeping only
+// the previous row, so nothing of the trajectory is stored. Feed it from
+// RungeKuttaSolver::SetStreaming with Sink().
+template <typename T>
+class TrajectorySummary
+{
+public:
+
+    explicit TrajectorySummary(int reductions = ReduceAll);
+
+    void Add(const T& t, const T& y);
+
+    // Adds each row the solver hands out; the summary must outlive the solve
+    typename RungeKuttaSolver<T>::RowSink Sink();
+
+    int GetReductions() const;
+
+    const SummaryValues<T>& GetValues() const;
+
+    void Clear();
+
+private:
+
+    int reductions;
+    T previousTime = T(0);
+    T previousValue = T(0);
+
+    // The last nonzero value, so a row that lands exactly on zero still
+    // counts as one crossing when the sign changes across it
+    T lastSign = T(0);
+    SummaryValues<T> values;
+};
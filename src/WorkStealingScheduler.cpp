@@ -0,0 +1,145 @@
+#include "WorkStealingScheduler.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+
+WorkStealingScheduler::WorkStealingScheduler(int threads) : group(threads, [this](int worker) { Work(worker); })
+{
+    // Workers only touch their queues once Run starts them
+    for (int worker = 0; worker < group.GetThreadCount(); worker++)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+}
+
+int WorkStealingScheduler::GetThreadCount() const
+{
+    return group.GetThreadCount();
+}
+
+void WorkStealingScheduler::SetStealing(bool enabled)
+{
+    stealing = enabled;
+}
+
+const SchedulerStats& WorkStealingScheduler::GetStats() const
+{
+    return stats;
+}
+
+void WorkStealingScheduler::Run(int count, int chunkSize, const std::function<void(int, int)>& task)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    const int threads = GetThreadCount();
+    chunkSize = std::max(1, chunkSize);
+    const int chunkCount = (count + chunkSize - 1) / chunkSize;
+
+    stats.tasks.assign(threads, 0);
+    stats.chunks.assign(threads, 0);
+    stats.steals.assign(threads, 0);
+    stats.busySeconds.assign(threads, 0);
+
+    // Contiguous blocks of chunks per worker, as a static split would give
+    for (int worker = 0; worker < threads; worker++)
+    {
+        std::deque<Chunk>& chunks = queues[worker]->chunks;
+        chunks.clear();
+        const int first = int((long long)chunkCount * worker / threads);
+        const int last = int((long long)chunkCount * (worker + 1) / threads);
+        for (int chunk = last - 1; chunk >= first; chunk--)
+        {
+            chunks.push_back({ chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize) });
+        }
+    }
+
+    this->task = &task;
+    remaining.store(chunkCount, std::memory_order_relaxed);
+    group.Run();
+    this->task = nullptr;
+}
+
+void WorkStealingScheduler::Work(int worker)
+{
+    TraceSpan span("tasks");
+    double busySeconds = 0;
+    long long tasks = 0, chunks = 0, steals = 0;
+
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        Chunk chunk;
+        if (!PopBottom(worker, chunk))
+        {
+            if (!stealing)
+            {
+                break;
+            }
+            if (!StealTop(worker, chunk))
+            {
+                // The last chunks are still running elsewhere
+                std::this_thread::yield();
+                continue;
+            }
+            steals++;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+            for (int index = chunk.begin; index < chunk.end; index++)
+            {
+                (*task)(worker, index);
+            }
+        }
+        catch (...)
+        {
+            // This chunk never completes, so the others stop rather than wait for it
+            remaining.store(0, std::memory_order_release);
+            throw;
+        }
+        busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        tasks += chunk.end - chunk.begin;
+        chunks++;
+        remaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    stats.tasks[worker] = tasks;
+    stats.chunks[worker] = chunks;
+    stats.steals[worker] = steals;
+    stats.busySeconds[worker] = busySeconds;
+}
+
+bool WorkStealingScheduler::PopBottom(int worker, Chunk& chunk)
+{
+    WorkerQueue& queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.chunks.empty())
+    {
+        return false;
+    }
+    chunk = queue.chunks.back();
+    queue.chunks.pop_back();
+    return true;
+}
+
+// Tries every other worker once, starting from the next one so that thieves
+// spread over different victims
+bool WorkStealingScheduler::StealTop(int thief, Chunk& chunk)
+{
+    const int threads = GetThreadCount();
+    for (int offset = 1; offset < threads; offset++)
+    {
+        WorkerQueue& queue = *queues[(thief + offset) % threads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.chunks.empty())
+        {
+            chunk = queue.chunks.front();
+            queue.chunks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
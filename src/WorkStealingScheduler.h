@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "WorkerGroup.h"
+
+// Per-worker counts from the last WorkStealingScheduler::Run
+struct SchedulerStats
+{
+    std::vector<long long> tasks;
+    std::vector<long long> chunks;
+    std::vector<long long> steals;
+    std::vector<double> busySeconds;
+};
+
+// Task scheduler for batches of independent jobs of very different cost, such
+// as ensemble members with adaptive steps or varying final times. The index
+// range is cut into chunks and dealt out in contiguous blocks, one deque per
+// worker, exactly like a static split. A worker takes its own chunks from the
+// bottom of its deque and, once it runs dry, steals from the top of another
+// worker's deque, where the work furthest from that owner sits. With stealing
+// turned off it is the static split, which the ensemble benchmark compares
+// against. The calling thread takes part as worker 0. If a task throws, the
+// remaining chunks are dropped and Run rethrows the first exception.
+class WorkStealingScheduler
+{
+public:
+
+    // 0 uses one thread per hardware thread
+    explicit WorkStealingScheduler(int threads = 0);
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    int GetThreadCount() const;
+
+    void SetStealing(bool enabled);
+
+    // Runs task(worker, index) for every index in [0, count), chunkSize
+    // indices per chunk, and returns once all have finished
+    void Run(int count, int chunkSize, const std::function<void(int, int)>& task);
+
+    const SchedulerStats& GetStats() const;
+
+private:
+
+    struct Chunk
+    {
+        int begin;
+        int end;
+    };
+
+    // Padded so that neighbouring workers' locks do not share a cache line
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Chunk> chunks;
+    };
+
+    void Work(int worker);
+
+    bool PopBottom(int worker, Chunk& chunk);
+
+    bool StealTop(int thief, Chunk& chunk);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    bool stealing = true;
+
+    const std::function<void(int, int)>* task = nullptr;
+    std::atomic<int> remaining{ 0 };
+
+    SchedulerStats stats;
+
+    // Last, so its threads start after and are joined before the rest
+    WorkerGroup group;
+};
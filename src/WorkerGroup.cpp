@@ -0,0 +1,98 @@
+#include "WorkerGroup.h"
+#include <algorithm>
+
+WorkerGroup::WorkerGroup(int threads, std::function<void(int)> work) : work(std::move(work))
+{
+    if (threads <= 0)
+    {
+        threads = std::max(1, int(std::thread::hardware_concurrency()));
+    }
+    for (int worker = 1; worker < threads; worker++)
+    {
+        workers.emplace_back(&WorkerGroup::WorkerLoop, this, worker);
+    }
+}
+
+WorkerGroup::~WorkerGroup()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int WorkerGroup::GetThreadCount() const
+{
+    return int(workers.size()) + 1;
+}
+
+void WorkerGroup::Run()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        busy = int(workers.size());
+        error = nullptr;
+        generation++;
+    }
+    wake.notify_all();
+
+    Call(0);
+
+    // Whatever work reads must outlive every worker still running it
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busy == 0; });
+    if (error)
+    {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+void WorkerGroup::WorkerLoop(int worker)
+{
+    long long seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+        }
+
+        Call(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+        {
+            finished.notify_one();
+        }
+    }
+}
+
+// An exception must not escape a worker thread, and worker 0 must still wait
+// for the others, so every worker's exception is held for Run to rethrow
+void WorkerGroup::Call(int worker)
+{
+    try
+    {
+        work(worker);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error)
+        {
+            error = std::current_exception();
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads that sleep until Run and then all call work(worker) once.
+// The calling thread takes part as worker 0, so a group of one thread runs
+// everything inline. This is the thread lifecycle shared by ThreadPool and
+// WorkStealingScheduler, which differ only in how work hands out indices.
+class WorkerGroup
+{
+public:
+
+    // 0 uses one thread per hardware thread. work must stay callable until
+    // the group is destroyed.
+    WorkerGroup(int threads, std::function<void(int)> work);
+    ~WorkerGroup();
+
+    WorkerGroup(const WorkerGroup&) = delete;
+    WorkerGroup& operator=(const WorkerGroup&) = delete;
+
+    int GetThreadCount() const;
+
+    // Calls work(worker) on every worker and returns once all have returned.
+    // State written before Run is visible to every worker. If any call
+    // throws, the first exception is rethrown here after the others finish.
+    void Run();
+
+private:
+
+    void WorkerLoop(int worker);
+
+    void Call(int worker);
+
+    std::function<void(int)> work;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    int busy = 0;
+    long long generation = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+};